@@ -0,0 +1,114 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <clientversion.h>
+#include <flatfile.h>
+#include <node/blockstorage.h>
+#include <node/blockview.h>
+#include <pow.h>
+#include <primitives/block.h>
+#include <random.h>
+#include <streams.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+static constexpr size_t READ_BLOCKS{10000};
+static constexpr size_t TXS_PER_BLOCK{20};
+//! Block file number used for the benchmark, well clear of the test chain.
+static constexpr int BENCH_BLOCK_FILE{9000};
+
+namespace {
+/** A regtest block with a mix of legacy and segwit spends. */
+CBlock MakeBenchBlock(const Consensus::Params& consensus)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    CBlock block;
+    block.nBits = UintToArith256(consensus.powLimit).GetCompact();
+    for (size_t i = 0; i < TXS_PER_BLOCK; ++i) {
+        CMutableTransaction tx;
+        tx.vin.resize(2);
+        for (auto& in : tx.vin) {
+            in.prevout = COutPoint{rng.rand256(), uint32_t(rng.randrange(4))};
+            if (i % 2) {
+                in.scriptWitness.stack = {rng.randbytes(71), rng.randbytes(33)};
+            } else {
+                in.scriptSig = CScript{} << rng.randbytes(71) << rng.randbytes(33);
+            }
+        }
+        tx.vout.resize(2);
+        for (auto& out : tx.vout) {
+            out.nValue = rng.randrange(100 * COIN);
+            out.scriptPubKey = CScript{} << OP_0 << rng.randbytes(20);
+        }
+        block.vtx.push_back(MakeTransactionRef(std::move(tx)));
+    }
+    while (!CheckProofOfWork(block.GetHash(), block.nBits, consensus)) ++block.nNonce;
+    return block;
+}
+
+/** Write READ_BLOCKS copies of `block` into a block file and return their positions. */
+std::vector<FlatFilePos> WriteBlockFile(const CBlock& block, const CMessageHeader::MessageStartChars& message_start)
+{
+    CDataStream ss{SER_DISK, CLIENT_VERSION};
+    ss << message_start << static_cast<uint32_t>(::GetSerializeSize(block, CLIENT_VERSION)) << block;
+
+    std::vector<FlatFilePos> positions;
+    FILE* file{fsbridge::fopen(node::GetBlockPosFilename(FlatFilePos{BENCH_BLOCK_FILE, 0}), "wb")};
+    for (size_t i = 0; i < READ_BLOCKS; ++i) {
+        positions.emplace_back(BENCH_BLOCK_FILE, i * ss.size() + node::BLOCK_SERIALIZATION_HEADER_SIZE);
+        if (fwrite(ss.data(), 1, ss.size(), file) != ss.size()) {
+            throw std::runtime_error("write to test file failed\n");
+        }
+    }
+    fclose(file);
+    return positions;
+}
+} // namespace
+
+// Reads a run of consecutive blocks the way txindex syncing does, collecting
+// the txid and serialized size of every transaction, once by deserializing
+// each block into a CBlock and once through memory-mapped lazy views.
+static void ReadBlocks(benchmark::Bench& bench, bool lazy)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::REGTEST)};
+    const CChainParams& params{testing_setup->m_node.chainman->GetParams()};
+    const std::vector<FlatFilePos> positions{WriteBlockFile(MakeBenchBlock(params.GetConsensus()), params.MessageStart())};
+
+    bench.batch(READ_BLOCKS).unit("block").run([&] {
+        size_t total_size{0};
+        for (const FlatFilePos& pos : positions) {
+            if (lazy) {
+                node::BlockView view;
+                bool read{node::ReadBlockView(view, pos, params.MessageStart())};
+                assert(read);
+                for (const node::TxView& tx : view.Transactions()) {
+                    total_size += tx.Raw().size() + tx.GetHash().GetUint64(0) % 2;
+                }
+            } else {
+                CBlock block;
+                bool read{node::ReadBlockFromDisk(block, pos, params.GetConsensus())};
+                assert(read);
+                for (const CTransactionRef& tx : block.vtx) {
+                    total_size += ::GetSerializeSize(*tx, CLIENT_VERSION) + tx->GetHash().GetUint64(0) % 2;
+                }
+            }
+        }
+        ankerl::nanobench::doNotOptimizeAway(total_size);
+    });
+    node::UnmapBlockFile(BENCH_BLOCK_FILE);
+}
+
+static void BlockReadDeserialize(benchmark::Bench& bench) { ReadBlocks(bench, /*lazy=*/false); }
+static void BlockReadView(benchmark::Bench& bench) { ReadBlocks(bench, /*lazy=*/true); }
+
+BENCHMARK(BlockReadDeserialize, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockReadView, benchmark::PriorityLevel::HIGH);
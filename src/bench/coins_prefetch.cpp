@@ -0,0 +1,78 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <bench/bench.h>
+#include <coins.h>
+#include <coinsprefetch.h>
+#include <random.h>
+#include <test/util/setup_common.h>
+#include <txdb.h>
+#include <uint256.h>
+
+#include <cassert>
+#include <vector>
+
+static constexpr size_t REPLAY_BLOCKS{40};
+static constexpr size_t INPUTS_PER_BLOCK{500};
+//! Number of blocks ActivateBestChainStep queues for connection at once.
+static constexpr size_t QUEUE_WINDOW{32};
+//! LevelDB cache for the chainstate, as with a small -dbcache.
+static constexpr size_t SMALL_DBCACHE_BYTES{1 << 20};
+
+// Replays the input lookups of a run of blocks against the coins database the
+// way IBD does with a small -dbcache: every block starts from an empty coins
+// cache, so each input is a cache miss that has to be served by the LevelDB
+// files below. With prefetching enabled, the inputs of the queued blocks are
+// read by worker threads while earlier blocks are being connected.
+static void CoinsReplay(benchmark::Bench& bench, int prefetch_threads)
+{
+    const auto testing_setup{MakeNoLogFileContext<const BasicTestingSetup>()};
+    CCoinsViewDB db{{.path = testing_setup->m_path_root / "chainstate", .cache_bytes = SMALL_DBCACHE_BYTES, .wipe_data = true}, {}};
+
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<std::vector<COutPoint>> blocks(REPLAY_BLOCKS);
+    std::vector<uint256> block_hashes;
+    CCoinsMap coins;
+    for (size_t i = 0; i < REPLAY_BLOCKS; ++i) {
+        block_hashes.push_back(ArithToUint256(arith_uint256{i + 1}));
+        for (size_t j = 0; j < INPUTS_PER_BLOCK; ++j) {
+            const COutPoint outpoint{rng.rand256(), uint32_t(rng.randrange(4))};
+            CScript script{CScript{} << OP_DUP << OP_HASH160 << rng.randbytes(20) << OP_EQUALVERIFY << OP_CHECKSIG};
+            coins.emplace(outpoint, CCoinsCacheEntry{Coin{CTxOut{1000, script}, 1, false}, CCoinsCacheEntry::DIRTY | CCoinsCacheEntry::FRESH});
+            blocks[i].push_back(outpoint);
+        }
+    }
+    bool written{db.BatchWrite(coins, block_hashes.back())};
+    assert(written);
+    // Reopen the database, which moves the coins from the LevelDB write
+    // buffer into table files, so that lookups have to read them from disk.
+    db.ResizeCache(SMALL_DBCACHE_BYTES);
+
+    CCoinsViewPrefetch prefetch{&db};
+    prefetch.StartThreads(prefetch_threads);
+
+    bench.batch(REPLAY_BLOCKS * INPUTS_PER_BLOCK).unit("input").run([&] {
+        for (size_t i = 0; i < REPLAY_BLOCKS; ++i) {
+            std::vector<std::pair<uint256, CCoinsViewPrefetch::LoaderFn>> queue;
+            for (size_t j = i; j < std::min(i + QUEUE_WINDOW, REPLAY_BLOCKS); ++j) {
+                queue.emplace_back(block_hashes[j], [&blocks, j] { return blocks[j]; });
+            }
+            prefetch.SetQueuedBlocks(std::move(queue));
+
+            CCoinsViewCache cache{&prefetch};
+            for (const COutPoint& outpoint : blocks[i]) {
+                bool unspent{!cache.AccessCoin(outpoint).IsSpent()};
+                assert(unspent);
+            }
+            prefetch.Release(block_hashes[i]);
+        }
+    });
+}
+
+static void CoinsReplayNoPrefetch(benchmark::Bench& bench) { CoinsReplay(bench, 0); }
+static void CoinsReplayPrefetch(benchmark::Bench& bench) { CoinsReplay(bench, DEFAULT_COINS_PREFETCH_THREADS); }
+
+BENCHMARK(CoinsReplayNoPrefetch, benchmark::PriorityLevel::HIGH);
+BENCHMARK(CoinsReplayPrefetch, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,61 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <index/blockfilterindex.h>
+#include <index/txindex.h>
+#include <interfaces/chain.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
+#include <test/util/setup_common.h>
+#include <util/strencodings.h>
+#include <util/system.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <cassert>
+#include <chrono>
+#include <memory>
+#include <type_traits>
+
+//! Length of the chain the indexes are built for.
+static constexpr int SYNC_CHAIN_LENGTH{200};
+
+// Builds an index from scratch over a mined chain through its background
+// sync, with the given number of -indexthreads.
+template <typename Index>
+static void IndexSync(benchmark::Bench& bench, int threads)
+{
+    const auto testing_setup{MakeNoLogFileContext<TestingSetup>(CBaseChainParams::REGTEST)};
+    node::NodeContext& node{testing_setup->m_node};
+    for (int i = 0; i < SYNC_CHAIN_LENGTH; ++i) {
+        MineBlock(node, P2WSH_OP_TRUE);
+    }
+    gArgs.ForceSetArg("-indexthreads", ToString(threads));
+
+    bench.batch(SYNC_CHAIN_LENGTH + 1).unit("block").run([&] {
+        std::unique_ptr<Index> index;
+        if constexpr (std::is_same_v<Index, BlockFilterIndex>) {
+            index = std::make_unique<Index>(interfaces::MakeChain(node), BlockFilterType::BASIC, 1 << 20, /*f_memory=*/true, /*f_wipe=*/true);
+        } else {
+            index = std::make_unique<Index>(interfaces::MakeChain(node), 1 << 20, /*f_memory=*/true, /*f_wipe=*/true);
+        }
+        bool started{index->Start()};
+        assert(started);
+        while (!index->BlockUntilSyncedToCurrentChain()) {
+            UninterruptibleSleep(std::chrono::milliseconds{1});
+        }
+        index->Stop();
+    });
+}
+
+static void TxIndexSyncSerial(benchmark::Bench& bench) { IndexSync<TxIndex>(bench, 0); }
+static void TxIndexSyncParallel(benchmark::Bench& bench) { IndexSync<TxIndex>(bench, DEFAULT_INDEX_THREADS); }
+static void BlockFilterIndexSyncSerial(benchmark::Bench& bench) { IndexSync<BlockFilterIndex>(bench, 0); }
+static void BlockFilterIndexSyncParallel(benchmark::Bench& bench) { IndexSync<BlockFilterIndex>(bench, DEFAULT_INDEX_THREADS); }
+
+BENCHMARK(TxIndexSyncSerial, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxIndexSyncParallel, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterIndexSyncSerial, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockFilterIndexSyncParallel, benchmark::PriorityLevel::HIGH);
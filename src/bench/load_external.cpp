@@ -6,9 +6,43 @@
 #include <bench/bench.h>
 #include <bench/data.h>
 #include <chainparams.h>
+#include <consensus/validation.h>
+#include <node/blockstorage.h>
 #include <test/util/setup_common.h>
+#include <util/threadpool.h>
 #include <validation.h>
 
+#include <cassert>
+#include <future>
+#include <vector>
+
+//! Block file number used by the reindex benchmarks, clear of the test chain.
+static constexpr int BENCH_BLOCK_FILE{9000};
+
+/** Create a file similar to a blk?????.dat file, filled with copies of the same block. */
+static void CreateBlockFile(const fs::path& blkfile, const CChainParams& params)
+{
+    // Create a single block as in the blocks files (magic bytes, block size,
+    // block data) as a stream object.
+    DataStream ss{};
+    ss << params.MessageStart();
+    ss << static_cast<uint32_t>(benchmark::data::block413567.size());
+    // We can't use the streaming serialization (ss << benchmark::data::block413567)
+    // because that first writes a compact size.
+    ss << Span{benchmark::data::block413567};
+
+    // Create the test file.
+    // "wb+" is "binary, O_RDWR | O_CREAT | O_TRUNC".
+    FILE* file{fsbridge::fopen(blkfile, "wb+")};
+    // Make the test block file about 128 MB in length.
+    for (size_t i = 0; i < node::MAX_BLOCKFILE_SIZE / ss.size(); ++i) {
+        if (fwrite(ss.data(), 1, ss.size(), file) != ss.size()) {
+            throw std::runtime_error("write to test file failed\n");
+        }
+    }
+    fclose(file);
+}
+
 /**
  * The LoadExternalBlockFile() function is used during -reindex and -loadblock.
  *
@@ -25,29 +59,8 @@ static void LoadExternalBlockFile(benchmark::Bench& bench)
 {
     const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::MAIN)};
 
-    // Create a single block as in the blocks files (magic bytes, block size,
-    // block data) as a stream object.
     const fs::path blkfile{testing_setup.get()->m_path_root / "blk.dat"};
-    DataStream ss{};
-    auto params{testing_setup->m_node.chainman->GetParams()};
-    ss << params.MessageStart();
-    ss << static_cast<uint32_t>(benchmark::data::block413567.size());
-    // We can't use the streaming serialization (ss << benchmark::data::block413567)
-    // because that first writes a compact size.
-    ss << Span{benchmark::data::block413567};
-
-    // Create the test file.
-    {
-        // "wb+" is "binary, O_RDWR | O_CREAT | O_TRUNC".
-        FILE* file{fsbridge::fopen(blkfile, "wb+")};
-        // Make the test block file about 128 MB in length.
-        for (size_t i = 0; i < node::MAX_BLOCKFILE_SIZE / ss.size(); ++i) {
-            if (fwrite(ss.data(), 1, ss.size(), file) != ss.size()) {
-                throw std::runtime_error("write to test file failed\n");
-            }
-        }
-        fclose(file);
-    }
+    CreateBlockFile(blkfile, testing_setup->m_node.chainman->GetParams());
 
     Chainstate& chainstate{testing_setup->m_node.chainman->ActiveChainstate()};
     std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
@@ -61,4 +74,56 @@ static void LoadExternalBlockFile(benchmark::Bench& bench)
     fs::remove(blkfile);
 }
 
+/**
+ * The first pass of a parallel -reindex (Chainstate::ReindexBlockFiles())
+ * locates the blocks of each block file by their headers only.
+ */
+static void ReindexScanBlockFile(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::MAIN)};
+    const CChainParams& params{testing_setup->m_node.chainman->GetParams()};
+
+    const FlatFilePos file_pos{BENCH_BLOCK_FILE, 0};
+    CreateBlockFile(node::GetBlockPosFilename(file_pos), params);
+
+    bench.run([&] {
+        const auto blocks{node::ScanBlockFile(file_pos.nFile, params)};
+        assert(!blocks.empty());
+    });
+    fs::remove(node::GetBlockPosFilename(file_pos));
+}
+
+/**
+ * The second pass reads, deserializes and checks the located blocks on worker
+ * threads ahead of accepting them, which is measured here.
+ */
+static void ReindexReadBlocks(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::MAIN)};
+    const CChainParams& params{testing_setup->m_node.chainman->GetParams()};
+
+    const FlatFilePos file_pos{BENCH_BLOCK_FILE, 0};
+    CreateBlockFile(node::GetBlockPosFilename(file_pos), params);
+    const auto blocks{node::ScanBlockFile(file_pos.nFile, params)};
+
+    ThreadPool pool{"bench"};
+    pool.Start(kernel::DEFAULT_REINDEX_THREADS);
+    bench.run([&] {
+        std::vector<std::future<bool>> reads;
+        for (const node::ScannedBlock& scanned : blocks) {
+            reads.push_back(pool.Submit([&scanned, &params] {
+                CBlock block;
+                if (!node::ReadBlockFromDisk(block, scanned.pos, params.GetConsensus())) return false;
+                BlockValidationState state;
+                return CheckBlock(block, state, params.GetConsensus());
+            }));
+        }
+        for (auto& read : reads) read.get();
+    });
+    pool.Stop();
+    fs::remove(node::GetBlockPosFilename(file_pos));
+}
+
 BENCHMARK(LoadExternalBlockFile, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReindexScanBlockFile, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ReindexReadBlocks, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,57 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <chain.h>
+#include <consensus/validation.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <cassert>
+
+//! Number of blocks disconnected and connected by every reorg.
+static constexpr int REORG_DEPTH{100};
+
+// Switches the active chain back and forth between two equal-work branches of
+// REORG_DEPTH blocks, so that every iteration disconnects and reconnects a
+// whole branch through ActivateBestChain.
+static void Reorg(benchmark::Bench& bench)
+{
+    const auto testing_setup{MakeNoLogFileContext<const TestingSetup>(CBaseChainParams::REGTEST)};
+    const node::NodeContext& node{testing_setup->m_node};
+    ChainstateManager& chainman{*node.chainman};
+    Chainstate& chainstate{chainman.ActiveChainstate()};
+
+    // The branches pay to different scripts, so that their blocks differ.
+    const auto mine_branch{[&](const CScript& coinbase_script) {
+        CBlockIndex* first{nullptr};
+        for (int i = 0; i < REORG_DEPTH; ++i) {
+            MineBlock(node, coinbase_script);
+            if (!first) first = WITH_LOCK(cs_main, return chainman.ActiveChain().Tip());
+        }
+        return std::make_pair(first, WITH_LOCK(cs_main, return chainman.ActiveChain().Tip()));
+    }};
+    const auto [first_a, tip_a]{mine_branch(P2WSH_OP_TRUE)};
+
+    // Mine the second branch from the same parent, then make the first one a
+    // candidate for the active chain again.
+    BlockValidationState state;
+    bool invalidated{chainstate.InvalidateBlock(state, first_a)};
+    assert(invalidated);
+    const auto [first_b, tip_b]{mine_branch(CScript{} << OP_TRUE)};
+    WITH_LOCK(cs_main, chainstate.ResetBlockFailureFlags(first_a));
+
+    bool on_a{false};
+    bench.unit("reorg").run([&] {
+        CBlockIndex* target{on_a ? tip_b : tip_a};
+        bool activated{chainstate.PreciousBlock(state, target)};
+        assert(activated);
+        assert(WITH_LOCK(cs_main, return chainman.ActiveChain().Tip()) == target);
+        on_a = !on_a;
+    });
+}
+
+BENCHMARK(Reorg, benchmark::PriorityLevel::HIGH);
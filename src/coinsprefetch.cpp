@@ -0,0 +1,185 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coinsprefetch.h>
+
+#include <logging.h>
+#include <primitives/block.h>
+#include <util/time.h>
+
+#include <algorithm>
+#include <set>
+
+CCoinsViewPrefetch::CCoinsViewPrefetch(CCoinsView* view) : CCoinsViewBacked(view) {}
+
+CCoinsViewPrefetch::~CCoinsViewPrefetch()
+{
+    StopThreads();
+}
+
+bool CCoinsViewPrefetch::GetCoin(const COutPoint& outpoint, Coin& coin) const
+{
+    {
+        LOCK(m_mutex);
+        auto it{m_staged.find(outpoint)};
+        if (it != m_staged.end()) {
+            // The cache above takes ownership of the coin; it will not ask again.
+            coin = std::move(it->second);
+            m_staged.erase(it);
+            ++m_stats.hits;
+            return true;
+        }
+    }
+    const auto start{SteadyClock::now()};
+    const bool found{base->GetCoin(outpoint, coin)};
+    const auto stall{SteadyClock::now() - start};
+    LOCK(m_mutex);
+    ++m_stats.misses;
+    m_stats.stall_time += std::chrono::duration_cast<std::chrono::microseconds>(stall);
+    return found;
+}
+
+bool CCoinsViewPrefetch::HaveCoin(const COutPoint& outpoint) const
+{
+    if (WITH_LOCK(m_mutex, return m_staged.count(outpoint) > 0)) return true;
+    return base->HaveCoin(outpoint);
+}
+
+bool CCoinsViewPrefetch::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, bool erase)
+{
+    // Hold the lock for the whole write: a fetch that started before it may
+    // have read the old value, and one that starts during it may read either.
+    // Bumping the epoch makes sure neither ends up in the staging area.
+    LOCK(m_mutex);
+    ++m_epoch;
+    if (!m_staged.empty()) {
+        for (const auto& [outpoint, entry] : mapCoins) {
+            if (entry.flags & CCoinsCacheEntry::DIRTY) m_staged.erase(outpoint);
+        }
+    }
+    return base->BatchWrite(mapCoins, hashBlock, erase);
+}
+
+void CCoinsViewPrefetch::StartThreads(int threads_num)
+{
+    m_pool.Start(std::min(threads_num, MAX_COINS_PREFETCH_THREADS));
+}
+
+void CCoinsViewPrefetch::StopThreads()
+{
+    m_interrupt = true;
+    m_pool.Stop();
+    m_interrupt = false;
+    Clear();
+}
+
+void CCoinsViewPrefetch::SetQueuedBlocks(std::vector<std::pair<uint256, LoaderFn>> blocks)
+{
+    if (m_pool.WorkersCount() == 0) return;
+    if (blocks.size() > MAX_PREFETCH_BLOCKS) blocks.resize(MAX_PREFETCH_BLOCKS);
+
+    std::vector<std::pair<uint256, LoaderFn>> to_schedule;
+    {
+        LOCK(m_mutex);
+        std::set<uint256> queued;
+        for (const auto& [hash, loader] : blocks) queued.insert(hash);
+        for (auto it{m_blocks.begin()}; it != m_blocks.end();) {
+            if (queued.count(it->first)) {
+                ++it;
+                continue;
+            }
+            for (const COutPoint& outpoint : it->second) m_staged.erase(outpoint);
+            it = m_blocks.erase(it);
+        }
+        for (auto& [hash, loader] : blocks) {
+            if (m_blocks.emplace(hash, std::vector<COutPoint>{}).second) {
+                to_schedule.emplace_back(hash, std::move(loader));
+            }
+        }
+    }
+
+    for (auto& [hash, loader] : to_schedule) {
+        m_pool.Submit([this, block_hash = hash, load = std::move(loader)] {
+            if (m_interrupt) return;
+            std::vector<COutPoint> outpoints{load()};
+            {
+                LOCK(m_mutex);
+                auto it{m_blocks.find(block_hash)};
+                if (it == m_blocks.end()) return; // released while loading
+                it->second = outpoints;
+            }
+            // Split the lookups so that the inputs of a single large block are
+            // fetched by several workers at once.
+            for (size_t i{0}; i < outpoints.size(); i += PREFETCH_BATCH_SIZE) {
+                const auto first{outpoints.begin() + i};
+                const auto last{outpoints.begin() + std::min(i + PREFETCH_BATCH_SIZE, outpoints.size())};
+                m_pool.Submit([this, block_hash, batch = std::vector<COutPoint>(first, last)] {
+                    FetchBatch(block_hash, batch);
+                });
+            }
+        });
+    }
+}
+
+void CCoinsViewPrefetch::FetchBatch(const uint256& block_hash, const std::vector<COutPoint>& outpoints)
+{
+    for (const COutPoint& outpoint : outpoints) {
+        if (m_interrupt) return;
+        uint64_t epoch;
+        {
+            LOCK(m_mutex);
+            if (!m_blocks.count(block_hash)) return;
+            if (m_staged.count(outpoint)) continue;
+            epoch = m_epoch;
+        }
+        Coin coin;
+        // Coins that are missing here were either created by an earlier queued
+        // block or are being spent invalidly; both are resolved by the caller.
+        if (!base->GetCoin(outpoint, coin)) continue;
+        LOCK(m_mutex);
+        if (epoch != m_epoch || !m_blocks.count(block_hash)) continue;
+        if (m_staged.emplace(outpoint, std::move(coin)).second) ++m_stats.fetched;
+    }
+}
+
+void CCoinsViewPrefetch::Release(const uint256& block_hash)
+{
+    LOCK(m_mutex);
+    auto it{m_blocks.find(block_hash)};
+    if (it == m_blocks.end()) return;
+    for (const COutPoint& outpoint : it->second) m_staged.erase(outpoint);
+    m_blocks.erase(it);
+}
+
+void CCoinsViewPrefetch::Clear()
+{
+    LOCK(m_mutex);
+    m_staged.clear();
+    m_blocks.clear();
+}
+
+size_t CCoinsViewPrefetch::StagedCount() const
+{
+    return WITH_LOCK(m_mutex, return m_staged.size());
+}
+
+CoinsPrefetchStats CCoinsViewPrefetch::GetStats() const
+{
+    return WITH_LOCK(m_mutex, return m_stats);
+}
+
+std::vector<COutPoint> GetBlockPrevouts(const CBlock& block)
+{
+    std::vector<COutPoint> outpoints;
+    std::set<uint256> created;
+    for (const auto& tx : block.vtx) {
+        if (!tx->IsCoinBase()) {
+            for (const CTxIn& txin : tx->vin) {
+                if (!created.count(txin.prevout.hash)) outpoints.push_back(txin.prevout);
+            }
+        }
+        created.insert(tx->GetHash());
+    }
+    return outpoints;
+}
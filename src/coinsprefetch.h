@@ -0,0 +1,118 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_COINSPREFETCH_H
+#define BITCOIN_COINSPREFETCH_H
+
+#include <coins.h>
+#include <primitives/transaction.h>
+#include <sync.h>
+#include <uint256.h>
+#include <util/hasher.h>
+#include <util/threadpool.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+class CBlock;
+
+//! -prefetchthreads default: number of threads fetching coins for queued blocks
+static constexpr int DEFAULT_COINS_PREFETCH_THREADS{4};
+//! Maximum -prefetchthreads
+static constexpr int MAX_COINS_PREFETCH_THREADS{16};
+//! Maximum number of blocks whose inputs may be staged at any one time
+static constexpr size_t MAX_PREFETCH_BLOCKS{64};
+//! Number of outpoints looked up by a single prefetch task
+static constexpr size_t PREFETCH_BATCH_SIZE{128};
+
+/** Counters describing how well prefetching kept up with block connection. */
+struct CoinsPrefetchStats {
+    //! Lookups served from the staging area.
+    uint64_t hits{0};
+    //! Lookups that had to go to the database synchronously.
+    uint64_t misses{0};
+    //! Coins fetched into the staging area by worker threads.
+    uint64_t fetched{0};
+    //! Total time the caller spent blocked on database reads for misses.
+    std::chrono::microseconds stall_time{0};
+};
+
+/**
+ * Read-only staging layer that sits between the chainstate's coins cache and
+ * the coins database.
+ *
+ * Blocks queued for connection are handed to SetQueuedBlocks(); a pool of worker
+ * threads reads them, collects the outpoints they spend and fetches the
+ * corresponding coins from the database into an in-memory staging area. A
+ * later cache miss in ConnectBlock is then served from memory instead of a
+ * synchronous LevelDB read, overlapping disk I/O with script validation.
+ *
+ * Staged coins are never modified; BatchWrite() evicts every outpoint it
+ * writes and invalidates fetches that are still in flight, so the staging area
+ * never holds a value older than the database beneath it.
+ */
+class CCoinsViewPrefetch final : public CCoinsViewBacked
+{
+public:
+    //! Returns the outpoints to fetch for one block. Runs on a worker thread.
+    using LoaderFn = std::function<std::vector<COutPoint>()>;
+
+    explicit CCoinsViewPrefetch(CCoinsView* view);
+    ~CCoinsViewPrefetch() override;
+
+    bool GetCoin(const COutPoint& outpoint, Coin& coin) const override;
+    bool HaveCoin(const COutPoint& outpoint) const override;
+    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, bool erase = true) override;
+
+    //! Start the worker threads. Prefetching is a no-op when no threads are running.
+    void StartThreads(int threads_num);
+    //! Abandon outstanding work and join the worker threads.
+    void StopThreads();
+
+    /**
+     * Set the blocks expected to be connected next, in connection order.
+     * Blocks that are no longer queued are released; newly queued blocks
+     * have their inputs scheduled for fetching, up to MAX_PREFETCH_BLOCKS.
+     * Does nothing if no worker threads are running.
+     */
+    void SetQueuedBlocks(std::vector<std::pair<uint256, LoaderFn>> blocks) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Drop any coins still staged for a block once it has been connected (or abandoned).
+    void Release(const uint256& block_hash) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Drop all staged coins.
+    void Clear() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    //! Number of coins currently staged.
+    size_t StagedCount() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    CoinsPrefetchStats GetStats() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    void FetchBatch(const uint256& block_hash, const std::vector<COutPoint>& outpoints) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    mutable Mutex m_mutex;
+    //! Coins read ahead of time, consumed by GetCoin().
+    mutable std::unordered_map<COutPoint, Coin, SaltedOutpointHasher> m_staged GUARDED_BY(m_mutex);
+    //! Outpoints staged for each scheduled block, so they can be released together.
+    std::map<uint256, std::vector<COutPoint>> m_blocks GUARDED_BY(m_mutex);
+    //! Bumped by every write; fetches started under an older epoch are discarded.
+    uint64_t m_epoch GUARDED_BY(m_mutex){0};
+    mutable CoinsPrefetchStats m_stats GUARDED_BY(m_mutex);
+    std::atomic<bool> m_interrupt{false};
+
+    //! Declared last so that its workers are joined before the state above is destroyed.
+    ThreadPool m_pool{"prefetch"};
+};
+
+//! Outpoints spent by a block, excluding those created earlier in the same block.
+std::vector<COutPoint> GetBlockPrevouts(const CBlock& block);
+
+#endif // BITCOIN_COINSPREFETCH_H
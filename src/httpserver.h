@@ -6,6 +6,9 @@
 #ifndef BITCOIN_HTTPSERVER_H
 #define BITCOIN_HTTPSERVER_H
 
+#include <span.h>
+
+#include <cstddef>
 #include <functional>
 #include <optional>
 #include <string>
@@ -125,6 +128,8 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+    /** Write HTTP reply with a binary body, see above. */
+    void WriteReply(int nStatus, Span<const std::byte> reply);
 };
 
 /** Get the query parameter value from request uri for a specified key, or std::nullopt if the key
@@ -9,6 +9,7 @@
 #include <kernel/chain.h>
 #include <logging.h>
 #include <node/blockstorage.h>
+#include <node/blockview.h>
 #include <node/context.h>
 #include <node/database_args.h>
 #include <node/interface_ui.h>
@@ -17,19 +18,31 @@
 #include <util/syscall_sandbox.h>
 #include <util/system.h>
 #include <util/thread.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <validation.h> // For g_chainman
 #include <warnings.h>
 
+#include <algorithm>
+#include <deque>
+#include <future>
+#include <memory>
 #include <string>
 #include <utility>
 
+using node::BlockFileReadGuard;
 using node::ReadBlockFromDisk;
+using node::ReadBlockView;
+using node::UndoReadFromDisk;
 
 constexpr uint8_t DB_BEST_BLOCK{'B'};
 
 constexpr auto SYNC_LOG_INTERVAL{30s};
 constexpr auto SYNC_LOCATOR_WRITE_INTERVAL{30s};
+//! Blocks read ahead of the parallel sync, per worker thread.
+constexpr size_t SYNC_READ_AHEAD_PER_THREAD{16};
+//! Size at which the entries accumulated by the parallel sync are written out.
+constexpr size_t SYNC_BATCH_MAX_SIZE{16 << 20};
 
 template <typename... Args>
 static void FatalError(const char* fmt, const Args&... args)
@@ -159,9 +172,13 @@ void BaseIndex::ThreadSync()
 {
     SetSyscallSandboxPolicy(SyscallSandboxPolicy::TX_INDEX);
     const CBlockIndex* pindex = m_best_block_index.load();
+    if (!m_synced && m_sync_threads > 0 && !ThreadSyncParallel(pindex)) {
+        return;
+    }
     if (!m_synced) {
         auto& consensus_params = Params().GetConsensus();
 
+        const auto sync_start_time{std::chrono::steady_clock::now()};
         std::chrono::steady_clock::time_point last_log_time{0s};
         std::chrono::steady_clock::time_point last_locator_write_time{0s};
         while (true) {
@@ -207,8 +224,16 @@ void BaseIndex::ThreadSync()
             }
 
             CBlock block;
+            node::BlockView view;
             interfaces::BlockInfo block_info = kernel::MakeBlockInfo(pindex);
-            if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
+            if (UsesBlockView()) {
+                if (!ReadBlockView(view, pindex, Params().MessageStart())) {
+                    FatalError("%s: Failed to read block %s from disk",
+                               __func__, pindex->GetBlockHash().ToString());
+                    return;
+                }
+                block_info.view = &view;
+            } else if (!ReadBlockFromDisk(block, pindex, consensus_params)) {
                 FatalError("%s: Failed to read block %s from disk",
                            __func__, pindex->GetBlockHash().ToString());
                 return;
@@ -220,6 +245,8 @@ void BaseIndex::ThreadSync()
                            __func__, pindex->GetBlockHash().ToString());
                 return;
             }
+            ++m_synced_blocks;
+            m_sync_time = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - sync_start_time);
         }
     }
 
@@ -230,6 +257,146 @@ void BaseIndex::ThreadSync()
     }
 }
 
+bool BaseIndex::ThreadSyncParallel(const CBlockIndex*& pindex)
+{
+    // A block handed to the workers. The disk positions they read from are
+    // captured under cs_main when it is queued, along with a guard that keeps
+    // the data at those positions until the block is prepared, even if its
+    // files are pruned or compacted in the meantime.
+    struct SyncTask {
+        const CBlockIndex* pindex;
+        std::future<std::unique_ptr<PreparedBlock>> prepared;
+    };
+
+    const auto& consensus_params = Params().GetConsensus();
+    const auto& message_start = Params().MessageStart();
+    const bool uses_view{UsesBlockView()};
+    const bool uses_undo{UsesUndoData()};
+    const auto prepare{[&, this](interfaces::BlockInfo block_info, FlatFilePos undo_pos) -> std::unique_ptr<PreparedBlock> {
+        const FlatFilePos block_pos{block_info.file_number, block_info.data_pos};
+        CBlock block;
+        node::BlockView view;
+        CBlockUndo block_undo;
+        if (uses_view) {
+            if (!ReadBlockView(view, block_pos, message_start) || view.GetHash() != block_info.hash) return nullptr;
+            block_info.view = &view;
+        } else {
+            if (!ReadBlockFromDisk(block, block_pos, consensus_params) || block.GetHash() != block_info.hash) return nullptr;
+            block_info.data = &block;
+        }
+        if (uses_undo && block_info.prev_hash) {
+            if (!UndoReadFromDisk(block_undo, undo_pos, *block_info.prev_hash)) return nullptr;
+            block_info.undo_data = &block_undo;
+        }
+        return PrepareBlock(block_info);
+    }};
+
+    ThreadPool pool{GetName() + ".sync"};
+    pool.Start(m_sync_threads);
+    std::deque<SyncTask> queue;
+    const size_t max_queued{SYNC_READ_AHEAD_PER_THREAD * m_sync_threads};
+    // Last block handed to the workers. pindex is the last one appended.
+    const CBlockIndex* pindex_queued{pindex};
+
+    CDBBatch batch(GetDB());
+    const auto write_batch{[&] {
+        bool ok{GetDB().WriteBatch(batch)};
+        batch.Clear();
+        return ok;
+    }};
+
+    const auto sync_start_time{std::chrono::steady_clock::now()};
+    std::chrono::steady_clock::time_point last_log_time{0s};
+    std::chrono::steady_clock::time_point last_locator_write_time{0s};
+    while (true) {
+        if (m_interrupt) {
+            // Whatever is queued behind pindex is dropped. Entries appended so
+            // far are written, as the locator is only advanced past them by
+            // the Commit below.
+            pool.Stop();
+            if (write_batch()) {
+                SetBestBlockIndex(pindex);
+                // No need to handle errors in Commit. See rationale in ThreadSync.
+                Commit();
+            }
+            return false;
+        }
+
+        if (queue.size() < max_queued / 2 || queue.empty()) {
+            LOCK(cs_main);
+            while (queue.size() < max_queued) {
+                const CBlockIndex* pindex_next = NextSyncBlock(pindex_queued, m_chainstate->m_chain);
+                if (!pindex_next || pindex_next->pprev != pindex_queued) {
+                    // Append what is queued before catching up with the tip or
+                    // rewinding away from a stale branch.
+                    if (!queue.empty()) break;
+                    if (!write_batch()) {
+                        FatalError("%s: Failed to write to index %s database", __func__, GetName());
+                        return false;
+                    }
+                    SetBestBlockIndex(pindex);
+                    if (!pindex_next) {
+                        m_synced = true;
+                        // No need to handle errors in Commit. See rationale in ThreadSync.
+                        Commit();
+                        return true;
+                    }
+                    if (!Rewind(pindex, pindex_next->pprev)) {
+                        FatalError("%s: Failed to rewind index %s to a previous chain tip",
+                                   __func__, GetName());
+                        return false;
+                    }
+                    pindex = pindex_queued = pindex_next->pprev;
+                    continue;
+                }
+                // The undo data of a block is in the rev file with the number
+                // of its blk file, which the guard covers as well.
+                auto guard{std::make_shared<const BlockFileReadGuard>(pindex_next->GetBlockPos().nFile)};
+                queue.push_back({pindex_next, pool.Submit([&prepare, block_info = kernel::MakeBlockInfo(pindex_next), undo_pos = pindex_next->GetUndoPos(), guard = std::move(guard)] {
+                    return prepare(block_info, undo_pos);
+                })});
+                pindex_queued = pindex_next;
+            }
+        }
+
+        SyncTask task{std::move(queue.front())};
+        queue.pop_front();
+        const std::unique_ptr<PreparedBlock> prepared{task.prepared.get()};
+        if (!prepared) {
+            FatalError("%s: Failed to read block %s from disk",
+                       __func__, task.pindex->GetBlockHash().ToString());
+            return false;
+        }
+        if (!CustomAppendPrepared(kernel::MakeBlockInfo(task.pindex), *prepared, batch) ||
+            (batch.SizeEstimate() > SYNC_BATCH_MAX_SIZE && !write_batch())) {
+            FatalError("%s: Failed to write block %s to index database",
+                       __func__, task.pindex->GetBlockHash().ToString());
+            return false;
+        }
+        pindex = task.pindex;
+
+        auto current_time{std::chrono::steady_clock::now()};
+        ++m_synced_blocks;
+        m_sync_time = std::chrono::duration_cast<std::chrono::microseconds>(current_time - sync_start_time);
+        if (last_log_time + SYNC_LOG_INTERVAL < current_time) {
+            LogPrintf("Syncing %s with block chain from height %d using %d threads\n",
+                      GetName(), pindex->nHeight, m_sync_threads);
+            last_log_time = current_time;
+        }
+
+        if (last_locator_write_time + SYNC_LOCATOR_WRITE_INTERVAL < current_time) {
+            if (!write_batch()) {
+                FatalError("%s: Failed to write to index %s database", __func__, GetName());
+                return false;
+            }
+            SetBestBlockIndex(pindex);
+            last_locator_write_time = current_time;
+            // No need to handle errors in Commit. See rationale in ThreadSync.
+            Commit();
+        }
+    }
+}
+
 bool BaseIndex::Commit()
 {
     // Don't commit anything if we haven't indexed any block yet
@@ -281,7 +448,8 @@ void BaseIndex::BlockConnected(const std::shared_ptr<const CBlock>& block, const
 
     const CBlockIndex* best_block_index = m_best_block_index.load();
     if (!best_block_index) {
-        if (pindex->nHeight != 0) {
+        // ViceversaChain: genesis is not at height 0, check for a parent instead
+        if (pindex->pprev) {
             FatalError("%s: First block connected is not the genesis block (height=%d)",
                        __func__, pindex->nHeight);
             return;
@@ -403,6 +571,10 @@ bool BaseIndex::Start()
         return false;
     }
 
+    if (AllowParallelSync()) {
+        m_sync_threads = std::clamp<int>(gArgs.GetIntArg("-indexthreads", DEFAULT_INDEX_THREADS), 0, MAX_INDEX_THREADS);
+    }
+
     m_thread_sync = std::thread(&util::TraceThread, GetName(), [this] { ThreadSync(); });
     return true;
 }
@@ -422,6 +594,12 @@ IndexSummary BaseIndex::GetSummary() const
     summary.name = GetName();
     summary.synced = m_synced;
     summary.best_block_height = m_best_block_index ? m_best_block_index.load()->nHeight : 0;
+    summary.sync_threads = m_sync_threads;
+    summary.synced_blocks = m_synced_blocks;
+    const auto sync_time{m_sync_time.load()};
+    if (sync_time.count() > 0) {
+        summary.sync_blocks_per_second = summary.synced_blocks / std::chrono::duration<double>{sync_time}.count();
+    }
     return summary;
 }
 
@@ -11,6 +11,8 @@
 #include <util/threadinterrupt.h>
 #include <validationinterface.h>
 
+#include <chrono>
+#include <memory>
 #include <string>
 
 class CBlock;
@@ -24,8 +26,19 @@ struct IndexSummary {
     std::string name;
     bool synced{false};
     int best_block_height{0};
+    //! Number of worker threads used by the background sync (0 if serial).
+    int sync_threads{0};
+    //! Blocks appended by the background sync since startup.
+    uint64_t synced_blocks{0};
+    //! Average rate of the background sync since startup.
+    double sync_blocks_per_second{0.0};
 };
 
+/** Default number of worker threads for the background sync of indexes that allow it. */
+static constexpr int DEFAULT_INDEX_THREADS{4};
+/** Maximum number of worker threads for the background sync of an index. */
+static constexpr int MAX_INDEX_THREADS{16};
+
 /**
  * Base class for indices of blockchain data. This implements
  * CValidationInterface and ensures blocks are indexed sequentially according
@@ -33,6 +46,12 @@ struct IndexSummary {
  */
 class BaseIndex : public CValidationInterface
 {
+public:
+    /// Per-block result computed by PrepareBlock on a worker thread.
+    struct PreparedBlock {
+        virtual ~PreparedBlock() = default;
+    };
+
 protected:
     /**
      * The database stores a block locator of the chain the database is synced to
@@ -70,6 +89,12 @@ private:
     std::thread m_thread_sync;
     CThreadInterrupt m_interrupt;
 
+    /// Number of worker threads used by ThreadSync, from -indexthreads.
+    int m_sync_threads{0};
+    /// Blocks appended by ThreadSync and the time spent doing so, for GetSummary.
+    std::atomic<uint64_t> m_synced_blocks{0};
+    std::atomic<std::chrono::microseconds> m_sync_time{};
+
     /// Read best block locator and check that data needed to sync has not been pruned.
     bool Init();
 
@@ -80,6 +105,13 @@ private:
     /// over and the sync thread exits.
     void ThreadSync();
 
+    /// Background sync used by ThreadSync for indexes that AllowParallelSync().
+    /// Blocks are read and prepared by a pool of m_sync_threads workers, and
+    /// appended in chain order into batches that are written together with the
+    /// periodic locator commits. Returns true once the index is in sync, and
+    /// false if it was interrupted or failed.
+    bool ThreadSyncParallel(const CBlockIndex*& pindex);
+
     /// Write the current index state (eg. chain block locator and subclass-specific items) to disk.
     ///
     /// Recommendations for error handling:
@@ -110,6 +142,29 @@ protected:
     /// Write update index entries for a newly connected block.
     [[nodiscard]] virtual bool CustomAppend(const interfaces::BlockInfo& block) { return true; }
 
+    /// Whether CustomAppend can work from BlockInfo::view alone. If so, blocks
+    /// read during the background sync are memory-mapped instead of
+    /// deserialized, and BlockInfo::data is not set for them.
+    virtual bool UsesBlockView() const { return false; }
+
+    /// Whether PrepareBlock needs BlockInfo::undo_data. It is not provided to
+    /// CustomAppend, which reads it itself if needed.
+    virtual bool UsesUndoData() const { return false; }
+
+    /// Whether the work of CustomAppend can be split into PrepareBlock, which
+    /// only depends on the block itself, and CustomAppendPrepared, which
+    /// updates the index in chain order. Such indexes are synced in parallel.
+    virtual bool AllowParallelSync() const { return false; }
+
+    /// Compute the index entries of a block. Called concurrently from worker
+    /// threads during the background sync, so it must not touch index state.
+    /// Returns nullptr on failure.
+    [[nodiscard]] virtual std::unique_ptr<PreparedBlock> PrepareBlock(const interfaces::BlockInfo& block) const { return nullptr; }
+
+    /// Add the entries computed by PrepareBlock to `batch`. Called in chain
+    /// order; the batch is written before the next Commit.
+    [[nodiscard]] virtual bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared, CDBBatch& batch) { return false; }
+
     /// Virtual method called internally by Commit that can be overridden to atomically
     /// commit more index state.
     virtual bool CustomCommit(CDBBatch& batch) { return true; }
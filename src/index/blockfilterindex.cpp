@@ -215,34 +215,72 @@ size_t BlockFilterIndex::WriteFilterToDisk(FlatFilePos& pos, const BlockFilter&
     return data_size;
 }
 
+namespace {
+/** Filter of a block, computed by PrepareBlock. */
+struct PreparedFilter final : BaseIndex::PreparedBlock {
+    BlockFilter filter;
+};
+} // namespace
+
 bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
 {
     CBlockUndo block_undo;
-    uint256 prev_header;
 
-    if (block.height > 0) {
+    // ViceversaChain: genesis is not at height 0, check for a parent instead
+    if (block.prev_hash) {
         // pindex variable gives indexing code access to node internals. It
         // will be removed in upcoming commit
         const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
         if (!UndoReadFromDisk(block_undo, pindex)) {
             return false;
         }
+    }
 
-        std::pair<uint256, DBVal> read_out;
-        if (!m_db->Read(DBHeightKey(block.height - 1), read_out)) {
-            return false;
-        }
+    CDBBatch batch(*m_db);
+    if (!AppendFilter(block, BlockFilter(m_filter_type, *Assert(block.data), block_undo), batch)) {
+        return false;
+    }
+    return m_db->WriteBatch(batch);
+}
 
-        uint256 expected_block_hash = *Assert(block.prev_hash);
-        if (read_out.first != expected_block_hash) {
-            return error("%s: previous block header belongs to unexpected block %s; expected %s",
-                         __func__, read_out.first.ToString(), expected_block_hash.ToString());
-        }
+std::unique_ptr<BaseIndex::PreparedBlock> BlockFilterIndex::PrepareBlock(const interfaces::BlockInfo& block) const
+{
+    if (block.prev_hash && !block.undo_data) return nullptr;
+    auto prepared{std::make_unique<PreparedFilter>()};
+    prepared->filter = BlockFilter(m_filter_type, *Assert(block.data), block.undo_data ? *block.undo_data : CBlockUndo{});
+    return prepared;
+}
 
-        prev_header = read_out.second.header;
-    }
+bool BlockFilterIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared, CDBBatch& batch)
+{
+    return AppendFilter(block, static_cast<PreparedFilter&>(prepared).filter, batch);
+}
+
+bool BlockFilterIndex::AppendFilter(const interfaces::BlockInfo& block, const BlockFilter& filter, CDBBatch& batch)
+{
+    uint256 prev_header;
 
-    BlockFilter filter(m_filter_type, *Assert(block.data), block_undo);
+    if (block.prev_hash) {
+        const uint256& expected_block_hash = *block.prev_hash;
+        // During a parallel sync the entry of the previous block may still be
+        // in the pending batch.
+        if (m_last_header.first == expected_block_hash) {
+            prev_header = m_last_header.second;
+        } else {
+            // ViceversaChain: the parent is one height closer to genesis, so +1
+            std::pair<uint256, DBVal> read_out;
+            if (!m_db->Read(DBHeightKey(block.height + 1), read_out)) {
+                return false;
+            }
+
+            if (read_out.first != expected_block_hash) {
+                return error("%s: previous block header belongs to unexpected block %s; expected %s",
+                             __func__, read_out.first.ToString(), expected_block_hash.ToString());
+            }
+
+            prev_header = read_out.second.header;
+        }
+    }
 
     size_t bytes_written = WriteFilterToDisk(m_next_filter_pos, filter);
     if (bytes_written == 0) return false;
@@ -253,11 +291,10 @@ bool BlockFilterIndex::CustomAppend(const interfaces::BlockInfo& block)
     value.second.header = filter.ComputeHeader(prev_header);
     value.second.pos = m_next_filter_pos;
 
-    if (!m_db->Write(DBHeightKey(block.height), value)) {
-        return false;
-    }
+    batch.Write(DBHeightKey(block.height), value);
 
     m_next_filter_pos.nPos += bytes_written;
+    m_last_header = {block.hash, value.second.header};
     return true;
 }
 
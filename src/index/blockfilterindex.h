@@ -41,6 +41,12 @@ private:
     /** cache of block hash to filter header, to avoid disk access when responding to getcfcheckpt. */
     std::unordered_map<uint256, uint256, FilterHeaderHasher> m_headers_cache GUARDED_BY(m_cs_headers_cache);
 
+    /** Block hash and filter header of the last block appended, which may not be written yet. */
+    std::pair<uint256, uint256> m_last_header;
+
+    /** Write a filter to disk and add its entry to `batch`. */
+    bool AppendFilter(const interfaces::BlockInfo& block, const BlockFilter& filter, CDBBatch& batch);
+
     bool AllowPrune() const override { return true; }
 
 protected:
@@ -50,6 +56,14 @@ protected:
 
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool UsesUndoData() const override { return true; }
+
+    bool AllowParallelSync() const override { return true; }
+
+    std::unique_ptr<PreparedBlock> PrepareBlock(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared, CDBBatch& batch) override;
+
     bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
 
     BaseIndex::DB& GetDB() const LIFETIMEBOUND override { return *m_db; }
@@ -0,0 +1,362 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/scriptindex.h>
+
+#include <chainparams.h>
+#include <coins.h>
+#include <crypto/sha256.h>
+#include <dbwrapper.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <undo.h>
+#include <util/system.h>
+#include <validation.h>
+
+using node::ReadBlockFromDisk;
+using node::UndoReadFromDisk;
+
+/* The index database stores three kinds of entries per script, all keyed by the
+ * SHA256 of the scriptPubKey:
+ *
+ * - History entries, with keys [DB_SCRIPT_HISTORY, script hash, uint32 (BE) height,
+ *   uint32 (BE) position of the transaction in its block, 0 for inputs or 1 for
+ *   outputs, uint32 (BE) n].
+ *   Heights count down from genesis, so iterating a script's entries yields the
+ *   most recent ones first.
+ * - Unspent outputs, with keys [DB_SCRIPT_UTXO, script hash, outpoint].
+ * - The sum and number of the unspent outputs, with keys [DB_SCRIPT_BALANCE,
+ *   script hash], for scripts that have any.
+ *
+ * Spending entries are derived from the block undo data, which holds the
+ * outputs being spent.
+ */
+constexpr uint8_t DB_SCRIPT_HISTORY{'h'};
+constexpr uint8_t DB_SCRIPT_UTXO{'u'};
+constexpr uint8_t DB_SCRIPT_BALANCE{'b'};
+
+std::unique_ptr<ScriptIndex> g_script_index;
+
+namespace {
+
+uint256 ScriptKeyHash(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+struct DBHistoryKey {
+    uint256 script_hash;
+    uint32_t height{0};
+    uint32_t tx_pos{0};
+    bool spend{false};
+    uint32_t n{0};
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_SCRIPT_HISTORY);
+        s << script_hash;
+        ser_writedata32be(s, height);
+        ser_writedata32be(s, tx_pos);
+        ser_writedata8(s, spend ? 0 : 1);
+        ser_writedata32be(s, n);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        if (ser_readdata8(s) != DB_SCRIPT_HISTORY) {
+            throw std::ios_base::failure("Invalid format for script index DB history key");
+        }
+        s >> script_hash;
+        height = ser_readdata32be(s);
+        tx_pos = ser_readdata32be(s);
+        spend = ser_readdata8(s) == 0;
+        n = ser_readdata32be(s);
+    }
+};
+
+struct DBHistoryValue {
+    uint256 txid;
+    CAmount amount;
+    COutPoint prevout;
+
+    SERIALIZE_METHODS(DBHistoryValue, obj) { READWRITE(obj.txid, obj.amount, obj.prevout); }
+};
+
+struct DBUtxoKey {
+    uint256 script_hash;
+    COutPoint outpoint;
+
+    SERIALIZE_METHODS(DBUtxoKey, obj)
+    {
+        uint8_t prefix{DB_SCRIPT_UTXO};
+        READWRITE(prefix);
+        if (prefix != DB_SCRIPT_UTXO) {
+            throw std::ios_base::failure("Invalid format for script index DB utxo key");
+        }
+        READWRITE(obj.script_hash, obj.outpoint);
+    }
+};
+
+struct DBUtxoValue {
+    uint32_t height;
+    CAmount amount;
+    bool coinbase;
+
+    SERIALIZE_METHODS(DBUtxoValue, obj) { READWRITE(obj.height, obj.amount, obj.coinbase); }
+};
+
+struct DBBalance {
+    CAmount balance{0};
+    uint64_t utxo_count{0};
+
+    SERIALIZE_METHODS(DBBalance, obj) { READWRITE(obj.balance, VARINT(obj.utxo_count)); }
+};
+
+/** The index entries of a block. */
+struct BlockEntries final : BaseIndex::PreparedBlock {
+    std::vector<std::pair<DBHistoryKey, DBHistoryValue>> history;
+    std::vector<std::pair<DBUtxoKey, DBUtxoValue>> created;
+    std::vector<std::pair<DBUtxoKey, DBUtxoValue>> spent;
+};
+
+bool GetBlockEntries(const CBlock& block, const CBlockUndo& block_undo, int height, BlockEntries& entries)
+{
+    if (block_undo.vtxundo.size() + 1 != block.vtx.size()) {
+        return error("%s: undo data of block %s does not match its transactions", __func__, block.GetHash().ToString());
+    }
+
+    for (uint32_t tx_pos = 0; tx_pos < block.vtx.size(); ++tx_pos) {
+        const CTransaction& tx{*block.vtx[tx_pos]};
+        if (tx_pos > 0) {
+            const CTxUndo& tx_undo{block_undo.vtxundo[tx_pos - 1]};
+            if (tx_undo.vprevout.size() != tx.vin.size()) {
+                return error("%s: undo data of transaction %s does not match its inputs", __func__, tx.GetHash().ToString());
+            }
+            for (uint32_t n = 0; n < tx.vin.size(); ++n) {
+                const Coin& coin{tx_undo.vprevout[n]};
+                const uint256 script_hash{ScriptKeyHash(coin.out.scriptPubKey)};
+                entries.history.push_back({{script_hash, uint32_t(height), tx_pos, /*spend=*/true, n},
+                                           {tx.GetHash(), coin.out.nValue, tx.vin[n].prevout}});
+                entries.spent.push_back({{script_hash, tx.vin[n].prevout},
+                                         {coin.nHeight, coin.out.nValue, coin.IsCoinBase()}});
+            }
+        }
+        for (uint32_t n = 0; n < tx.vout.size(); ++n) {
+            const CTxOut& out{tx.vout[n]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            const uint256 script_hash{ScriptKeyHash(out.scriptPubKey)};
+            entries.history.push_back({{script_hash, uint32_t(height), tx_pos, /*spend=*/false, n},
+                                       {tx.GetHash(), out.nValue, COutPoint{}}});
+            entries.created.push_back({{script_hash, COutPoint{tx.GetHash(), n}},
+                                       {uint32_t(height), out.nValue, tx_pos == 0}});
+        }
+    }
+    return true;
+}
+} // namespace
+
+/** Access to the script index database (indexes/scriptindex/) */
+class ScriptIndex::DB : public BaseIndex::DB
+{
+public:
+    explicit DB(size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+};
+
+ScriptIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
+    BaseIndex::DB(gArgs.GetDataDirNet() / "indexes" / "scriptindex", n_cache_size, f_memory, f_wipe)
+{}
+
+ScriptIndex::ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "scriptindex"), m_db(std::make_unique<ScriptIndex::DB>(n_cache_size, f_memory, f_wipe))
+{}
+
+ScriptIndex::~ScriptIndex() = default;
+
+bool ScriptIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    CBlockUndo block_undo;
+    // Exclude genesis block outputs because they are not spendable.
+    // ViceversaChain: genesis is not at height 0, check for a parent instead
+    if (!block.prev_hash) return true;
+
+    // pindex variable gives indexing code access to node internals. It
+    // will be removed in upcoming commit
+    const CBlockIndex* pindex = WITH_LOCK(cs_main, return m_chainstate->m_blockman.LookupBlockIndex(block.hash));
+    if (!UndoReadFromDisk(block_undo, pindex)) {
+        return false;
+    }
+
+    BlockEntries entries;
+    if (!GetBlockEntries(*Assert(block.data), block_undo, block.height, entries)) {
+        return false;
+    }
+    CDBBatch batch(*m_db);
+    if (!CustomAppendPrepared(block, entries, batch)) {
+        return false;
+    }
+    return m_db->WriteBatch(batch);
+}
+
+std::unique_ptr<BaseIndex::PreparedBlock> ScriptIndex::PrepareBlock(const interfaces::BlockInfo& block) const
+{
+    auto entries{std::make_unique<BlockEntries>()};
+    if (!block.prev_hash) return entries;
+    if (!block.undo_data || !GetBlockEntries(*Assert(block.data), *block.undo_data, block.height, *entries)) {
+        return nullptr;
+    }
+    return entries;
+}
+
+bool ScriptIndex::UpdateBalances(const PreparedBlock& prepared, bool connect, CDBBatch& batch)
+{
+    // An empty batch means that everything appended before was written.
+    if (batch.SizeEstimate() == 0) m_pending_balances.clear();
+
+    const BlockEntries& entries{static_cast<const BlockEntries&>(prepared)};
+    std::map<uint256, std::pair<CAmount, int64_t>> changes;
+    for (const auto& [key, value] : entries.created) {
+        auto& change{changes[key.script_hash]};
+        change.first += connect ? value.amount : -value.amount;
+        change.second += connect ? 1 : -1;
+    }
+    for (const auto& [key, value] : entries.spent) {
+        auto& change{changes[key.script_hash]};
+        change.first += connect ? -value.amount : value.amount;
+        change.second += connect ? -1 : 1;
+    }
+    for (const auto& [script_hash, change] : changes) {
+        const auto db_key{std::make_pair(DB_SCRIPT_BALANCE, script_hash)};
+        auto it{m_pending_balances.find(script_hash)};
+        if (it == m_pending_balances.end()) {
+            // Scripts without unspent outputs have no entry.
+            DBBalance stored;
+            m_db->Read(db_key, stored);
+            it = m_pending_balances.emplace(script_hash, std::make_pair(stored.balance, stored.utxo_count)).first;
+        }
+        auto& [balance, utxo_count]{it->second};
+        balance += change.first;
+        utxo_count += change.second;
+        if (utxo_count == 0) {
+            batch.Erase(db_key);
+        } else {
+            batch.Write(db_key, DBBalance{balance, utxo_count});
+        }
+    }
+    return true;
+}
+
+bool ScriptIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared, CDBBatch& batch)
+{
+    if (!UpdateBalances(prepared, /*connect=*/true, batch)) return false;
+    const BlockEntries& entries{static_cast<BlockEntries&>(prepared)};
+    for (const auto& [key, value] : entries.history) {
+        batch.Write(key, value);
+    }
+    // Outputs created and spent within the block are written before they are
+    // erased, as the batch is applied in order.
+    for (const auto& [key, value] : entries.created) {
+        batch.Write(key, value);
+    }
+    for (const auto& [key, value] : entries.spent) {
+        batch.Erase(key);
+    }
+    return true;
+}
+
+bool ScriptIndex::CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip)
+{
+    LOCK(cs_main);
+    const CBlockIndex* iter_tip{m_chainstate->m_blockman.LookupBlockIndex(current_tip.hash)};
+    const CBlockIndex* new_tip_index{m_chainstate->m_blockman.LookupBlockIndex(new_tip.hash)};
+    const auto& consensus_params{Params().GetConsensus()};
+
+    CDBBatch batch(*m_db);
+    while (iter_tip != new_tip_index) {
+        CBlock block;
+        CBlockUndo block_undo;
+        BlockEntries entries;
+        if (!ReadBlockFromDisk(block, iter_tip, consensus_params) ||
+            !UndoReadFromDisk(block_undo, iter_tip) ||
+            !GetBlockEntries(block, block_undo, iter_tip->nHeight, entries)) {
+            return error("%s: Failed to read block %s from disk",
+                         __func__, iter_tip->GetBlockHash().ToString());
+        }
+        if (!UpdateBalances(entries, /*connect=*/false, batch)) return false;
+
+        // Undo CustomAppendPrepared in reverse order.
+        for (const auto& [key, value] : entries.spent) {
+            batch.Write(key, value);
+        }
+        for (const auto& [key, value] : entries.created) {
+            batch.Erase(key);
+        }
+        for (const auto& [key, value] : entries.history) {
+            batch.Erase(key);
+        }
+        iter_tip = iter_tip->pprev;
+    }
+    return m_db->WriteBatch(batch);
+}
+
+BaseIndex::DB& ScriptIndex::GetDB() const { return *m_db; }
+
+bool ScriptIndex::LookupHistory(const CScript& script, size_t skip, size_t count, std::vector<ScriptHistoryEntry>& entries) const
+{
+    const uint256 script_hash{ScriptKeyHash(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    db_it->Seek(std::make_pair(DB_SCRIPT_HISTORY, script_hash));
+
+    for (; db_it->Valid() && entries.size() < count; db_it->Next()) {
+        DBHistoryKey key;
+        if (!db_it->GetKey(key) || key.script_hash != script_hash) break;
+        if (skip > 0) {
+            --skip;
+            continue;
+        }
+        DBHistoryValue value;
+        if (!db_it->GetValue(value)) {
+            return error("%s: unable to read value in %s", __func__, GetName());
+        }
+        entries.push_back({value.txid, int(key.height), key.spend, key.n, value.amount, value.prevout});
+    }
+    return true;
+}
+
+bool ScriptIndex::LookupUtxos(const CScript& script, size_t skip, size_t count, std::vector<ScriptUtxo>& utxos) const
+{
+    const uint256 script_hash{ScriptKeyHash(script)};
+    std::unique_ptr<CDBIterator> db_it(m_db->NewIterator());
+    db_it->Seek(std::make_pair(DB_SCRIPT_UTXO, script_hash));
+
+    for (; db_it->Valid() && utxos.size() < count; db_it->Next()) {
+        DBUtxoKey key;
+        if (!db_it->GetKey(key) || key.script_hash != script_hash) break;
+        if (skip > 0) {
+            --skip;
+            continue;
+        }
+        DBUtxoValue value;
+        if (!db_it->GetValue(value)) {
+            return error("%s: unable to read value in %s", __func__, GetName());
+        }
+        utxos.push_back({key.outpoint, int(value.height), value.amount, value.coinbase});
+    }
+    return true;
+}
+
+bool ScriptIndex::LookupBalance(const CScript& script, CAmount& balance, uint64_t& utxo_count) const
+{
+    const auto db_key{std::make_pair(DB_SCRIPT_BALANCE, ScriptKeyHash(script))};
+    DBBalance stored;
+    m_db->Read(db_key, stored);
+    balance = stored.balance;
+    utxo_count = stored.utxo_count;
+    return true;
+}
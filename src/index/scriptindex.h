@@ -0,0 +1,108 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SCRIPTINDEX_H
+#define BITCOIN_INDEX_SCRIPTINDEX_H
+
+#include <consensus/amount.h>
+#include <index/base.h>
+#include <primitives/transaction.h>
+#include <uint256.h>
+
+#include <map>
+#include <utility>
+#include <vector>
+
+class CScript;
+
+static constexpr bool DEFAULT_SCRIPTINDEX{false};
+
+/** A transaction that paid to or spent from a script. */
+struct ScriptHistoryEntry {
+    uint256 txid;
+    int height;
+    //! Whether the transaction spent an output of the script rather than funding it.
+    bool spend;
+    //! Output index for funding entries, input index for spending entries.
+    uint32_t n;
+    CAmount amount;
+    //! The output that was spent, for spending entries.
+    COutPoint prevout;
+};
+
+/** An unspent output paying to a script. */
+struct ScriptUtxo {
+    COutPoint outpoint;
+    int height;
+    CAmount amount;
+    bool coinbase;
+};
+
+/**
+ * ScriptIndex records, for every scriptPubKey, the transactions that funded
+ * or spent it, the outputs that are still unspent and their running total.
+ * Scripts are keyed by their SHA256 hash, and history entries by height so
+ * that the most recent ones come first.
+ */
+class ScriptIndex final : public BaseIndex
+{
+protected:
+    class DB;
+
+private:
+    const std::unique_ptr<DB> m_db;
+
+    /// Balances and unspent output counts changed by the batch being built,
+    /// by script hash, as they are not in the database yet. Only touched by
+    /// the thread appending and rewinding blocks.
+    std::map<uint256, std::pair<CAmount, uint64_t>> m_pending_balances;
+
+    /// Add the outputs created and spent by a block to the balances of their
+    /// scripts, or take them away when rewinding it.
+    bool UpdateBalances(const PreparedBlock& entries, bool connect, CDBBatch& batch);
+
+    bool AllowPrune() const override { return false; }
+
+protected:
+    bool CustomAppend(const interfaces::BlockInfo& block) override;
+
+    bool CustomRewind(const interfaces::BlockKey& current_tip, const interfaces::BlockKey& new_tip) override;
+
+    bool UsesUndoData() const override { return true; }
+
+    bool AllowParallelSync() const override { return true; }
+
+    std::unique_ptr<PreparedBlock> PrepareBlock(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared, CDBBatch& batch) override;
+
+    BaseIndex::DB& GetDB() const override;
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit ScriptIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    // Destructor is declared because this class contains a unique_ptr to an incomplete type.
+    virtual ~ScriptIndex() override;
+
+    /// Look up the transactions touching a script, most recent first.
+    ///
+    /// @param[in]   script  The scriptPubKey to look up.
+    /// @param[in]   skip    Number of entries to skip.
+    /// @param[in]   count   Maximum number of entries to return.
+    /// @param[out]  entries The entries found.
+    /// @return  false on a database error.
+    bool LookupHistory(const CScript& script, size_t skip, size_t count, std::vector<ScriptHistoryEntry>& entries) const;
+
+    /// Look up the unspent outputs paying to a script, in outpoint order.
+    bool LookupUtxos(const CScript& script, size_t skip, size_t count, std::vector<ScriptUtxo>& utxos) const;
+
+    /// Look up the sum and number of the unspent outputs paying to a script.
+    bool LookupBalance(const CScript& script, CAmount& balance, uint64_t& utxo_count) const;
+};
+
+/// The global script history index. May be null.
+extern std::unique_ptr<ScriptIndex> g_script_index;
+
+#endif // BITCOIN_INDEX_SCRIPTINDEX_H
@@ -8,6 +8,7 @@
 #include <index/disktxpos.h>
 #include <logging.h>
 #include <node/blockstorage.h>
+#include <node/blockview.h>
 #include <util/system.h>
 #include <validation.h>
 
@@ -30,6 +31,9 @@ public:
 
     /// Write a batch of transaction positions to the DB.
     bool WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos);
+
+    /// Add transaction positions to a batch that is written later.
+    void WriteTxs(CDBBatch& batch, const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos);
 };
 
 TxIndex::DB::DB(size_t n_cache_size, bool f_memory, bool f_wipe) :
@@ -44,10 +48,15 @@ bool TxIndex::DB::ReadTxPos(const uint256 &txid, CDiskTxPos& pos) const
 bool TxIndex::DB::WriteTxs(const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos)
 {
     CDBBatch batch(*this);
+    WriteTxs(batch, v_pos);
+    return WriteBatch(batch);
+}
+
+void TxIndex::DB::WriteTxs(CDBBatch& batch, const std::vector<std::pair<uint256, CDiskTxPos>>& v_pos)
+{
     for (const auto& tuple : v_pos) {
         batch.Write(std::make_pair(DB_TXINDEX, tuple.first), tuple.second);
     }
-    return WriteBatch(batch);
 }
 
 TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
@@ -56,20 +65,58 @@ TxIndex::TxIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size,
 
 TxIndex::~TxIndex() = default;
 
-bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+namespace {
+/** Transaction positions of a block, computed by PrepareBlock. */
+struct PreparedTxs final : BaseIndex::PreparedBlock {
+    std::vector<std::pair<uint256, CDiskTxPos>> positions;
+};
+
+std::vector<std::pair<uint256, CDiskTxPos>> GetTxPositions(const interfaces::BlockInfo& block)
 {
+    std::vector<std::pair<uint256, CDiskTxPos>> vPos;
     // Exclude genesis block transaction because outputs are not spendable.
-    if (block.height == 0) return true;
+    // ViceversaChain: genesis is not at height 0, check for a parent instead
+    if (!block.prev_hash) return vPos;
+
+    if (block.view) {
+        // Only txids and serialized sizes are needed, which the view provides
+        // without deserializing the transactions.
+        CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block.view->TxCount()));
+        vPos.reserve(block.view->TxCount());
+        for (const node::TxView& tx : block.view->Transactions()) {
+            vPos.emplace_back(tx.GetHash(), pos);
+            pos.nTxOffset += tx.Raw().size();
+        }
+        return vPos;
+    }
 
     assert(block.data);
     CDiskTxPos pos({block.file_number, block.data_pos}, GetSizeOfCompactSize(block.data->vtx.size()));
-    std::vector<std::pair<uint256, CDiskTxPos>> vPos;
     vPos.reserve(block.data->vtx.size());
     for (const auto& tx : block.data->vtx) {
         vPos.emplace_back(tx->GetHash(), pos);
         pos.nTxOffset += ::GetSerializeSize(*tx, CLIENT_VERSION);
     }
-    return m_db->WriteTxs(vPos);
+    return vPos;
+}
+} // namespace
+
+bool TxIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    return m_db->WriteTxs(GetTxPositions(block));
+}
+
+std::unique_ptr<BaseIndex::PreparedBlock> TxIndex::PrepareBlock(const interfaces::BlockInfo& block) const
+{
+    auto prepared{std::make_unique<PreparedTxs>()};
+    prepared->positions = GetTxPositions(block);
+    return prepared;
+}
+
+bool TxIndex::CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared, CDBBatch& batch)
+{
+    m_db->WriteTxs(batch, static_cast<PreparedTxs&>(prepared).positions);
+    return true;
 }
 
 BaseIndex::DB& TxIndex::GetDB() const { return *m_db; }
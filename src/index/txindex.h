@@ -28,6 +28,14 @@ private:
 protected:
     bool CustomAppend(const interfaces::BlockInfo& block) override;
 
+    bool UsesBlockView() const override { return true; }
+
+    bool AllowParallelSync() const override { return true; }
+
+    std::unique_ptr<PreparedBlock> PrepareBlock(const interfaces::BlockInfo& block) const override;
+
+    bool CustomAppendPrepared(const interfaces::BlockInfo& block, PreparedBlock& prepared, CDBBatch& batch) override;
+
     BaseIndex::DB& GetDB() const override;
 
 public:
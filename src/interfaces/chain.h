@@ -32,6 +32,7 @@ struct bilingual_str;
 struct CBlockLocator;
 struct FeeCalculation;
 namespace node {
+class BlockView;
 struct NodeContext;
 } // namespace node
 
@@ -88,6 +89,9 @@ struct BlockInfo {
     unsigned data_pos = 0;
     const CBlock* data = nullptr;
     const CBlockUndo* undo_data = nullptr;
+    //! Lazy view of the serialized block, set instead of `data` when reading
+    //! from disk for indexes that can work without a deserialized block.
+    const node::BlockView* view = nullptr;
 
     BlockInfo(const uint256& hash LIFETIMEBOUND) : hash(hash) {}
 };
@@ -8,12 +8,20 @@
 
 namespace kernel {
 
+/** Default number of threads scanning and reading block files during -reindex (0 reindexes serially) */
+static constexpr int DEFAULT_REINDEX_THREADS{4};
+/** Maximum number of threads scanning and reading block files during -reindex */
+static constexpr int MAX_REINDEX_THREADS{16};
+
 /**
  * An options struct for `BlockManager`, more ergonomically referred to as
  * `BlockManager::Options` due to the using-declaration in `BlockManager`.
  */
 struct BlockManagerOpts {
     uint64_t prune_target{0};
+    bool prune_compact{false};
+    bool prune_punch_holes{false};
+    int reindex_threads{DEFAULT_REINDEX_THREADS};
 };
 
 } // namespace kernel
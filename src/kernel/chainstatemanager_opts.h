@@ -7,6 +7,7 @@
 #define BITCOIN_KERNEL_CHAINSTATEMANAGER_OPTS_H
 
 #include <arith_uint256.h>
+#include <coinsprefetch.h>
 #include <dbwrapper.h>
 #include <txdb.h>
 #include <uint256.h>
@@ -43,6 +44,8 @@ struct ChainstateManagerOpts {
     DBOptions block_tree_db{};
     DBOptions coins_db{};
     CoinsViewOptions coins_view{};
+    //! Number of threads fetching coins ahead of time for blocks queued for connection (0 to disable).
+    int coins_prefetch_threads{DEFAULT_COINS_PREFETCH_THREADS};
 };
 
 } // namespace kernel
@@ -26,6 +26,16 @@ std::optional<bilingual_str> ApplyArgsManOptions(const ArgsManager& args, BlockM
     }
     opts.prune_target = nPruneTarget;
 
+    opts.prune_compact = args.GetBoolArg("-prunecompact", opts.prune_compact);
+    opts.prune_punch_holes = args.GetBoolArg("-prunepunchholes", opts.prune_punch_holes);
+
+    if (auto value{args.GetIntArg("-reindexthreads")}) {
+        if (*value < 0 || *value > kernel::MAX_REINDEX_THREADS) {
+            return strprintf(Untranslated("-reindexthreads must be between 0 and %d"), kernel::MAX_REINDEX_THREADS);
+        }
+        opts.reindex_threads = *value;
+    }
+
     return std::nullopt;
 }
 } // namespace node
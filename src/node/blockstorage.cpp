@@ -7,11 +7,14 @@
 
 #include <chain.h>
 #include <clientversion.h>
+#include <consensus/consensus.h>
 #include <consensus/validation.h>
+#include <crypto/common.h>
 #include <flatfile.h>
 #include <hash.h>
 #include <logging.h>
 #include <kernel/chainparams.h>
+#include <node/blockview.h>
 #include <pow.h>
 #include <reverse_iterator.h>
 #include <shutdown.h>
@@ -19,11 +22,15 @@
 #include <streams.h>
 #include <undo.h>
 #include <util/fs.h>
+#include <util/fs_helpers.h>
 #include <util/syscall_sandbox.h>
 #include <util/system.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <cstring>
 #include <map>
+#include <optional>
 #include <unordered_map>
 
 namespace node {
@@ -121,6 +128,31 @@ CBlockIndex* BlockManager::AddToBlockIndex(const CBlockHeader& block, CBlockInde
     return pindexNew;
 }
 
+void BlockManager::PruneOneBlock(CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+
+    pindex->nStatus &= ~BLOCK_HAVE_DATA;
+    pindex->nStatus &= ~BLOCK_HAVE_UNDO;
+    pindex->nFile = 0;
+    pindex->nDataPos = 0;
+    pindex->nUndoPos = 0;
+    m_dirty_blockindex.insert(pindex);
+
+    // Prune from m_blocks_unlinked -- any block we prune would have
+    // to be downloaded again in order to consider its chain, at which
+    // point it would be considered as a candidate for
+    // m_blocks_unlinked or setBlockIndexCandidates.
+    auto range = m_blocks_unlinked.equal_range(pindex->pprev);
+    while (range.first != range.second) {
+        std::multimap<CBlockIndex*, CBlockIndex*>::iterator _it = range.first;
+        range.first++;
+        if (_it->second == pindex) {
+            m_blocks_unlinked.erase(_it);
+        }
+    }
+}
+
 void BlockManager::PruneOneBlockFile(const int fileNumber)
 {
     AssertLockHeld(cs_main);
@@ -129,30 +161,16 @@ void BlockManager::PruneOneBlockFile(const int fileNumber)
     for (auto& entry : m_block_index) {
         CBlockIndex* pindex = &entry.second;
         if (pindex->nFile == fileNumber) {
-            pindex->nStatus &= ~BLOCK_HAVE_DATA;
-            pindex->nStatus &= ~BLOCK_HAVE_UNDO;
-            pindex->nFile = 0;
-            pindex->nDataPos = 0;
-            pindex->nUndoPos = 0;
-            m_dirty_blockindex.insert(pindex);
-
-            // Prune from m_blocks_unlinked -- any block we prune would have
-            // to be downloaded again in order to consider its chain, at which
-            // point it would be considered as a candidate for
-            // m_blocks_unlinked or setBlockIndexCandidates.
-            auto range = m_blocks_unlinked.equal_range(pindex->pprev);
-            while (range.first != range.second) {
-                std::multimap<CBlockIndex*, CBlockIndex*>::iterator _it = range.first;
-                range.first++;
-                if (_it->second == pindex) {
-                    m_blocks_unlinked.erase(_it);
-                }
-            }
+            PruneOneBlock(pindex);
         }
     }
 
     m_blockfile_info[fileNumber].SetNull();
     m_dirty_fileinfo.insert(fileNumber);
+    if (auto it{m_blockfile_punched.find(fileNumber)}; it != m_blockfile_punched.end()) {
+        it->second = 0;
+    }
+    m_record_sizes.erase(fileNumber);
 }
 
 void BlockManager::FindFilesToPruneManual(std::set<int>& setFilesToPrune, int nManualPruneHeight, int chain_tip_height)
@@ -240,6 +258,251 @@ void BlockManager::FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPr
              nLastBlockWeCanPrune, count);
 }
 
+/**
+ * Read the header in front of a block or undo record that `file` is positioned
+ * at, and return the size of the whole record, including the header and the
+ * `trailer_size` bytes that follow the data.
+ */
+static std::optional<unsigned int> ReadRecordSize(FILE* file, unsigned int trailer_size)
+{
+    AutoFile filein{file};
+    if (filein.IsNull()) return std::nullopt;
+    try {
+        CMessageHeader::MessageStartChars start;
+        unsigned int size;
+        filein >> start >> size;
+        if (size > MAX_SIZE) return std::nullopt;
+        return BLOCK_SERIALIZATION_HEADER_SIZE + size + trailer_size;
+    } catch (const std::exception&) {
+        return std::nullopt;
+    }
+}
+
+/** Read a whole block or undo record, including its header, from where `file` is positioned. */
+static bool ReadRecord(FILE* file, unsigned int size, std::vector<uint8_t>& record)
+{
+    AutoFile filein{file};
+    if (filein.IsNull()) return false;
+    try {
+        record.resize(size);
+        filein.read(MakeWritableByteSpan(record));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+static bool WriteRecord(FILE* file, const std::vector<uint8_t>& record)
+{
+    AutoFile fileout{file};
+    if (fileout.IsNull()) return false;
+    try {
+        fileout.write(MakeByteSpan(record));
+    } catch (const std::exception&) {
+        return false;
+    }
+    return true;
+}
+
+std::optional<unsigned int> BlockManager::RecordSize(const FlatFilePos& pos, bool undo)
+{
+    AssertLockHeld(cs_LastBlockFile);
+    auto& sizes{m_record_sizes[pos.nFile]};
+    if (const auto it{sizes.find({undo, pos.nPos})}; it != sizes.end()) return it->second;
+    const auto size{undo ? ReadRecordSize(OpenUndoFile(pos, true), uint256::size()) : ReadRecordSize(OpenBlockFile(pos, true), 0)};
+    if (size) sizes.emplace(std::make_pair(undo, pos.nPos), *size);
+    return size;
+}
+
+bool BlockManager::RelocateBlock(CBlockIndex* pindex, CChain& active_chain, std::set<int>& undo_files)
+{
+    AssertLockHeld(cs_main);
+    LOCK(cs_LastBlockFile);
+
+    // Block and undo records are copied as stored: the undo checksum commits
+    // to the parent block hash, not to the position of the record.
+    const FlatFilePos block_pos{pindex->nFile, pindex->nDataPos - static_cast<unsigned int>(BLOCK_SERIALIZATION_HEADER_SIZE)};
+    const auto block_size{RecordSize(block_pos, /*undo=*/false)};
+    std::vector<uint8_t> block_record;
+    if (!block_size || !ReadRecord(OpenBlockFile(block_pos, true), *block_size, block_record)) {
+        return error("%s: Failed to read block %s at %s", __func__, pindex->GetBlockHash().ToString(), block_pos.ToString());
+    }
+    std::vector<uint8_t> undo_record;
+    if (pindex->nStatus & BLOCK_HAVE_UNDO) {
+        const FlatFilePos undo_pos{pindex->nFile, pindex->nUndoPos - static_cast<unsigned int>(BLOCK_SERIALIZATION_HEADER_SIZE)};
+        const auto undo_size{RecordSize(undo_pos, /*undo=*/true)};
+        if (!undo_size || !ReadRecord(OpenUndoFile(undo_pos, true), *undo_size, undo_record)) {
+            return error("%s: Failed to read undo data of %s at %s", __func__, pindex->GetBlockHash().ToString(), undo_pos.ToString());
+        }
+    }
+
+    FlatFilePos new_block_pos;
+    if (!FindBlockPos(new_block_pos, block_record.size(), pindex->nHeight, active_chain, pindex->GetBlockTime(), false)) {
+        return error("%s: FindBlockPos failed", __func__);
+    }
+    if (!WriteRecord(OpenBlockFile(new_block_pos), block_record)) {
+        return AbortNode("Failed to write block");
+    }
+    FlatFilePos new_undo_pos;
+    if (!undo_record.empty()) {
+        BlockValidationState state;
+        if (!FindUndoPos(state, new_block_pos.nFile, new_undo_pos, undo_record.size())) {
+            return error("%s: FindUndoPos failed", __func__);
+        }
+        if (!WriteRecord(OpenUndoFile(new_undo_pos), undo_record)) {
+            return AbortNode("Failed to write undo data");
+        }
+        undo_files.insert(new_undo_pos.nFile);
+    }
+
+    pindex->nFile = new_block_pos.nFile;
+    pindex->nDataPos = new_block_pos.nPos + BLOCK_SERIALIZATION_HEADER_SIZE;
+    if (!undo_record.empty()) pindex->nUndoPos = new_undo_pos.nPos + BLOCK_SERIALIZATION_HEADER_SIZE;
+    m_dirty_blockindex.insert(pindex);
+    return true;
+}
+
+void BlockManager::CompactBlockFiles(std::set<int>& setFilesToPrune, CChain& active_chain, int prune_height)
+{
+    AssertLockHeld(cs_main);
+    LOCK(cs_LastBlockFile);
+    if (!m_opts.prune_compact && !m_opts.prune_punch_holes) return;
+    if (GetPruneTarget() == 0 || GetPruneTarget() == PRUNE_TARGET_MANUAL) return;
+    const int chain_tip_height{active_chain.Height()};
+    if (chain_tip_height < 0) return;
+
+    // ViceversaChain: as in FindFilesToPrune, blocks at or above this height are old enough to prune
+    const unsigned int nLastBlockWeCanPrune{(unsigned)std::max(prune_height, chain_tip_height + static_cast<int>(MIN_BLOCKS_TO_KEEP))};
+    const uint64_t nBuffer{BLOCKFILE_CHUNK_SIZE + UNDOFILE_CHUNK_SIZE};
+    uint64_t nCurrentUsage{CalculateCurrentUsage()};
+    if (nCurrentUsage + nBuffer < GetPruneTarget()) return;
+
+    // The blocks still stored in each file that FindFilesToPrune kept.
+    std::map<int, std::vector<CBlockIndex*>> file_blocks;
+    for (auto& [_, block_index] : m_block_index) {
+        if ((block_index.nStatus & BLOCK_HAVE_DATA) && block_index.nFile < m_last_blockfile) {
+            file_blocks[block_index.nFile].push_back(&block_index);
+        }
+    }
+
+    int compacted{0};
+    size_t punched{0};
+    uint64_t reclaimed{0};
+    std::set<int> undo_files;
+    for (auto& [file, blocks] : file_blocks) {
+        if (nCurrentUsage + nBuffer < GetPruneTarget()) break;
+
+        std::vector<CBlockIndex*> live;
+        std::vector<PrunedRange> dead;
+        uint64_t dead_bytes{0};
+        bool sizes_known{true};
+        for (CBlockIndex* pindex : blocks) {
+            if (static_cast<unsigned int>(pindex->nHeight) < nLastBlockWeCanPrune) {
+                live.push_back(pindex);
+                continue;
+            }
+            const FlatFilePos block_pos{file, pindex->nDataPos - static_cast<unsigned int>(BLOCK_SERIALIZATION_HEADER_SIZE)};
+            const auto block_size{RecordSize(block_pos, /*undo=*/false)};
+            sizes_known &= block_size.has_value();
+            if (block_size) dead.push_back({file, /*undo=*/false, block_pos.nPos, *block_size});
+            if (pindex->nStatus & BLOCK_HAVE_UNDO) {
+                const FlatFilePos undo_pos{file, pindex->nUndoPos - static_cast<unsigned int>(BLOCK_SERIALIZATION_HEADER_SIZE)};
+                const auto undo_size{RecordSize(undo_pos, /*undo=*/true)};
+                sizes_known &= undo_size.has_value();
+                if (undo_size) dead.push_back({file, /*undo=*/true, undo_pos.nPos, *undo_size});
+            }
+        }
+        if (dead.empty() || !sizes_known) continue;
+        for (const PrunedRange& range : dead) dead_bytes += range.length;
+
+        const auto it_punched{m_blockfile_punched.find(file)};
+        const uint64_t file_bytes{uint64_t{m_blockfile_info[file].nSize} + m_blockfile_info[file].nUndoSize -
+                                  (it_punched != m_blockfile_punched.end() ? it_punched->second : 0)};
+        const uint64_t live_bytes{file_bytes - std::min(file_bytes, dead_bytes)};
+        if (m_opts.prune_compact && live_bytes * 100 <= file_bytes * PRUNE_COMPACT_MAX_LIVE_PERCENT) {
+            // Copy in file order, so that the old file is read sequentially.
+            std::sort(live.begin(), live.end(), [](const CBlockIndex* a, const CBlockIndex* b) { return a->nDataPos < b->nDataPos; });
+            bool relocated{true};
+            for (CBlockIndex* pindex : live) {
+                if (!RelocateBlock(pindex, active_chain, undo_files)) {
+                    relocated = false;
+                    break;
+                }
+            }
+            // Blocks copied before a failure stay at their new position, and
+            // the old file is kept until all of them could be moved.
+            if (!relocated) continue;
+            PruneOneBlockFile(file);
+            setFilesToPrune.insert(file);
+            nCurrentUsage -= std::min(nCurrentUsage, file_bytes - live_bytes);
+            reclaimed += file_bytes - live_bytes;
+            ++compacted;
+        } else if (m_opts.prune_punch_holes && m_punch_holes_supported) {
+            for (CBlockIndex* pindex : blocks) {
+                if (static_cast<unsigned int>(pindex->nHeight) >= nLastBlockWeCanPrune) PruneOneBlock(pindex);
+            }
+            m_pending_hole_punches.insert(m_pending_hole_punches.end(), dead.begin(), dead.end());
+            for (const PrunedRange& range : dead) m_record_sizes[file].erase({range.undo, range.pos});
+            nCurrentUsage -= std::min(nCurrentUsage, dead_bytes);
+            punched += dead.size();
+        }
+    }
+    for (const int file : undo_files) {
+        FlushUndoFile(file);
+    }
+    m_reclaimed_bytes += reclaimed;
+
+    if (compacted > 0 || punched > 0) {
+        LogPrint(BCLog::PRUNE, "Compact: max_prune_height=%d rewrote %d blk/rev pairs reclaiming %dMiB, queued %u ranges to deallocate\n",
+                 nLastBlockWeCanPrune, compacted, reclaimed / 1024 / 1024, punched);
+    }
+}
+
+bool BlockManager::HavePendingHolePunches()
+{
+    LOCK(cs_LastBlockFile);
+    return !m_pending_hole_punches.empty();
+}
+
+void BlockManager::PunchPrunedHoles()
+{
+    LOCK(cs_LastBlockFile);
+
+    uint64_t reclaimed{0};
+    // Ranges of files that are being read are deallocated by a later call.
+    std::vector<PrunedRange> deferred;
+    for (const PrunedRange& range : m_pending_hole_punches) {
+        if (IsBlockFileRead(range.file)) {
+            deferred.push_back(range);
+            continue;
+        }
+        const FlatFilePos pos{range.file, range.pos};
+        AutoFile file{range.undo ? OpenUndoFile(pos) : OpenBlockFile(pos)};
+        if (file.IsNull()) continue;
+        if (!PunchFileHole(file.Get(), range.pos, range.length)) {
+            LogPrintf("Prune: deallocating pruned blocks is not supported here, not punching holes into block files anymore\n");
+            m_punch_holes_supported = false;
+            break;
+        }
+        if (!range.undo) UnmapBlockFile(range.file);
+        m_blockfile_punched[range.file] += range.length;
+        m_dirty_fileinfo.insert(range.file);
+        reclaimed += range.length;
+    }
+    m_pending_hole_punches.clear();
+    if (m_punch_holes_supported) m_pending_hole_punches = std::move(deferred);
+    m_reclaimed_bytes += reclaimed;
+    if (reclaimed > 0) {
+        LogPrint(BCLog::PRUNE, "Prune: deallocated %dKiB of pruned blocks\n", reclaimed / 1024);
+    }
+}
+
+uint64_t BlockManager::GetReclaimedBytes()
+{
+    LOCK(cs_LastBlockFile);
+    return m_reclaimed_bytes;
+}
+
 void BlockManager::UpdatePruneLock(const std::string& name, const PruneLockInfo& lock_info) {
     AssertLockHeld(::cs_main);
     m_prune_locks[name] = lock_info;
@@ -320,7 +583,14 @@ bool BlockManager::WriteBlockIndexDB()
         vBlocks.push_back(*it);
         m_dirty_blockindex.erase(it++);
     }
-    if (!m_block_tree_db->WriteBatchSync(vFiles, m_last_blockfile, vBlocks)) {
+    std::vector<std::pair<int, uint64_t>> punched;
+    for (const auto& [file, _] : vFiles) {
+        if (auto it{m_blockfile_punched.find(file)}; it != m_blockfile_punched.end()) {
+            punched.emplace_back(*it);
+            if (it->second == 0) m_blockfile_punched.erase(it);
+        }
+    }
+    if (!m_block_tree_db->WriteBatchSync(vFiles, m_last_blockfile, vBlocks, punched)) {
         return false;
     }
     return true;
@@ -338,6 +608,10 @@ bool BlockManager::LoadBlockIndexDB(const Consensus::Params& consensus_params)
     LogPrintf("%s: last block file = %i\n", __func__, m_last_blockfile);
     for (int nFile = 0; nFile <= m_last_blockfile; nFile++) {
         m_block_tree_db->ReadBlockFileInfo(nFile, m_blockfile_info[nFile]);
+        uint64_t punched;
+        if (m_block_tree_db->ReadBlockFilePunched(nFile, punched)) {
+            m_blockfile_punched[nFile] = punched;
+        }
     }
     LogPrintf("%s: last block file info: %s\n", __func__, m_blockfile_info[m_last_blockfile].ToString());
     for (int nFile = m_last_blockfile + 1; true; nFile++) {
@@ -506,8 +780,18 @@ static bool UndoWriteToDisk(const CBlockUndo& blockundo, FlatFilePos& pos, const
 
 bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex)
 {
-    const FlatFilePos pos{WITH_LOCK(::cs_main, return pindex->GetUndoPos())};
+    FlatFilePos pos;
+    std::optional<BlockFileReadGuard> guard;
+    {
+        LOCK(::cs_main);
+        pos = pindex->GetUndoPos();
+        guard.emplace(pos.nFile);
+    }
+    return UndoReadFromDisk(blockundo, pos, pindex->pprev->GetBlockHash());
+}
 
+bool UndoReadFromDisk(CBlockUndo& blockundo, const FlatFilePos& pos, const uint256& prev_hash)
+{
     if (pos.IsNull()) {
         return error("%s: no undo data available", __func__);
     }
@@ -522,7 +806,7 @@ bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex)
     uint256 hashChecksum;
     HashVerifier verifier{filein}; // Use HashVerifier as reserializing may lose data, c.f. commit d342424301013ec47dc146a4beb49d5c9319d80a
     try {
-        verifier << pindex->pprev->GetBlockHash();
+        verifier << prev_hash;
         verifier >> blockundo;
         filein >> hashChecksum;
     } catch (const std::exception& e) {
@@ -575,22 +859,69 @@ uint64_t BlockManager::CalculateCurrentUsage()
     for (const CBlockFileInfo& file : m_blockfile_info) {
         retval += file.nSize + file.nUndoSize;
     }
+    for (const auto& [_, punched] : m_blockfile_punched) {
+        retval -= std::min(retval, punched);
+    }
     return retval;
 }
 
-void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune)
+static Mutex g_block_file_readers_mutex;
+//! Number of BlockFileReadGuards held, by file number
+static std::map<int, int> g_block_file_readers GUARDED_BY(g_block_file_readers_mutex);
+//! Pruned files that are unlinked once their last BlockFileReadGuard is released
+static std::set<int> g_block_files_to_unlink GUARDED_BY(g_block_file_readers_mutex);
+
+static void UnlinkPrunedFile(int file)
 {
     std::error_code ec;
-    for (std::set<int>::iterator it = setFilesToPrune.begin(); it != setFilesToPrune.end(); ++it) {
-        FlatFilePos pos(*it, 0);
-        const bool removed_blockfile{fs::remove(BlockFileSeq().FileName(pos), ec)};
-        const bool removed_undofile{fs::remove(UndoFileSeq().FileName(pos), ec)};
-        if (removed_blockfile || removed_undofile) {
-            LogPrint(BCLog::BLOCKSTORE, "Prune: %s deleted blk/rev (%05u)\n", __func__, *it);
+    FlatFilePos pos(file, 0);
+    UnmapBlockFile(file);
+    const bool removed_blockfile{fs::remove(BlockFileSeq().FileName(pos), ec)};
+    const bool removed_undofile{fs::remove(UndoFileSeq().FileName(pos), ec)};
+    if (removed_blockfile || removed_undofile) {
+        LogPrint(BCLog::BLOCKSTORE, "Prune: %s deleted blk/rev (%05u)\n", __func__, file);
+    }
+}
+
+void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune)
+{
+    for (const int file : setFilesToPrune) {
+        {
+            LOCK(g_block_file_readers_mutex);
+            if (g_block_file_readers.count(file)) {
+                g_block_files_to_unlink.insert(file);
+                continue;
+            }
         }
+        UnlinkPrunedFile(file);
     }
 }
 
+BlockFileReadGuard::BlockFileReadGuard(int file) : m_file{file}
+{
+    LOCK(g_block_file_readers_mutex);
+    ++g_block_file_readers[m_file];
+}
+
+BlockFileReadGuard::~BlockFileReadGuard()
+{
+    {
+        LOCK(g_block_file_readers_mutex);
+        const auto it{g_block_file_readers.find(m_file)};
+        if (--it->second > 0) return;
+        g_block_file_readers.erase(it);
+        // No new guard can be taken for a pruned file, as no block refers to it anymore.
+        if (g_block_files_to_unlink.erase(m_file) == 0) return;
+    }
+    UnlinkPrunedFile(m_file);
+}
+
+bool IsBlockFileRead(int file)
+{
+    LOCK(g_block_file_readers_mutex);
+    return g_block_file_readers.count(file) > 0;
+}
+
 static FlatFileSeq BlockFileSeq()
 {
     return FlatFileSeq(gArgs.GetBlocksDirPath(), "blk", gArgs.GetBoolArg("-fastprune", false) ? 0x4000 /* 16kb */ : BLOCKFILE_CHUNK_SIZE);
@@ -779,7 +1110,13 @@ bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::P
 
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams)
 {
-    const FlatFilePos block_pos{WITH_LOCK(cs_main, return pindex->GetBlockPos())};
+    FlatFilePos block_pos;
+    std::optional<BlockFileReadGuard> guard;
+    {
+        LOCK(cs_main);
+        block_pos = pindex->GetBlockPos();
+        guard.emplace(block_pos.nFile);
+    }
 
     if (!ReadBlockFromDisk(block, block_pos, consensusParams)) {
         return false;
@@ -826,6 +1163,48 @@ bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos, c
     return true;
 }
 
+std::vector<ScannedBlock> ScanBlockFile(int file_number, const CChainParams& params)
+{
+    std::vector<ScannedBlock> blocks;
+    const auto mapped{MappedBlockFile::Open(file_number)};
+    if (!mapped) {
+        LogPrintf("%s: Could not map block file blk%05u.dat\n", __func__, file_number);
+        return blocks;
+    }
+    const Span<const uint8_t> data{mapped->Data()};
+    const CMessageHeader::MessageStartChars& message_start{params.MessageStart()};
+    size_t pos{0};
+    while (pos + BLOCK_SERIALIZATION_HEADER_SIZE + 80 <= data.size()) {
+        // Find the next candidate message start. Block files are pre-allocated
+        // with zeroes, which this skips quickly.
+        const void* found{memchr(data.data() + pos, message_start[0], data.size() - pos)};
+        if (!found) break;
+        pos = static_cast<const uint8_t*>(found) - data.data();
+        if (pos + BLOCK_SERIALIZATION_HEADER_SIZE + 80 > data.size()) break;
+        if (memcmp(data.data() + pos, message_start, CMessageHeader::MESSAGE_START_SIZE)) {
+            ++pos;
+            continue;
+        }
+        const uint32_t size{ReadLE32(data.data() + pos + CMessageHeader::MESSAGE_START_SIZE)};
+        const size_t block_pos{pos + BLOCK_SERIALIZATION_HEADER_SIZE};
+        if (size < 80 || size > MAX_BLOCK_SERIALIZED_SIZE || block_pos + size > data.size()) {
+            ++pos;
+            continue;
+        }
+        ScannedBlock block;
+        SpanReader{SER_DISK, CLIENT_VERSION, data.subspan(block_pos, 80)} >> block.header;
+        block.hash = block.header.GetHash();
+        if (!CheckProofOfWork(block.hash, block.header.nBits, params.GetConsensus())) {
+            ++pos;
+            continue;
+        }
+        block.pos = FlatFilePos{file_number, static_cast<unsigned int>(block_pos)};
+        blocks.push_back(std::move(block));
+        pos = block_pos + size;
+    }
+    return blocks;
+}
+
 FlatFilePos BlockManager::SaveBlockToDisk(const CBlock& block, int nHeight, CChain& active_chain, const CChainParams& chainparams, const FlatFilePos* dbp)
 {
     unsigned int nBlockSize = ::GetSerializeSize(block, CLIENT_VERSION);
@@ -879,26 +1258,35 @@ void ThreadImport(ChainstateManager& chainman, std::vector<fs::path> vImportFile
 
         // -reindex
         if (fReindex) {
-            int nFile = 0;
-            // Map of disk positions for blocks with unknown parent (only used for reindex);
-            // parent hash -> child disk position, multiple children can have the same parent.
-            std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
-            while (true) {
-                FlatFilePos pos(nFile, 0);
-                if (!fs::exists(GetBlockPosFilename(pos))) {
-                    break; // No block files left to reindex
-                }
-                FILE* file = OpenBlockFile(pos, true);
-                if (!file) {
-                    break; // This error is logged in OpenBlockFile
-                }
-                LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
-                chainman.ActiveChainstate().LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
+            const int reindex_threads{chainman.m_blockman.GetReindexThreads()};
+            if (reindex_threads > 0) {
+                chainman.ActiveChainstate().ReindexBlockFiles(reindex_threads);
                 if (ShutdownRequested()) {
                     LogPrintf("Shutdown requested. Exit %s\n", __func__);
                     return;
                 }
-                nFile++;
+            } else {
+                int nFile = 0;
+                // Map of disk positions for blocks with unknown parent (only used for reindex);
+                // parent hash -> child disk position, multiple children can have the same parent.
+                std::multimap<uint256, FlatFilePos> blocks_with_unknown_parent;
+                while (true) {
+                    FlatFilePos pos(nFile, 0);
+                    if (!fs::exists(GetBlockPosFilename(pos))) {
+                        break; // No block files left to reindex
+                    }
+                    FILE* file = OpenBlockFile(pos, true);
+                    if (!file) {
+                        break; // This error is logged in OpenBlockFile
+                    }
+                    LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
+                    chainman.ActiveChainstate().LoadExternalBlockFile(file, &pos, &blocks_with_unknown_parent);
+                    if (ShutdownRequested()) {
+                        LogPrintf("Shutdown requested. Exit %s\n", __func__);
+                        return;
+                    }
+                    nFile++;
+                }
             }
             WITH_LOCK(::cs_main, chainman.m_blockman.m_block_tree_db->WriteReindexing(false));
             fReindex = false;
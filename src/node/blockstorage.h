@@ -8,6 +8,7 @@
 
 #include <attributes.h>
 #include <chain.h>
+#include <flatfile.h>
 #include <kernel/blockmanager_opts.h>
 #include <kernel/cs_main.h>
 #include <protocol.h>
@@ -17,7 +18,10 @@
 
 #include <atomic>
 #include <cstdint>
+#include <map>
+#include <optional>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 class ArgsManager;
@@ -37,6 +41,12 @@ struct Params;
 
 namespace node {
 static constexpr bool DEFAULT_STOPAFTERBLOCKIMPORT{false};
+/** Default for -prunecompact */
+static constexpr bool DEFAULT_PRUNE_COMPACT{false};
+/** Default for -prunepunchholes */
+static constexpr bool DEFAULT_PRUNE_PUNCH_HOLES{false};
+/** With -prunecompact, block files whose live blocks take up at most this share of them are rewritten */
+static constexpr unsigned int PRUNE_COMPACT_MAX_LIVE_PERCENT{25};
 
 /** The pre-allocation chunk size for blk?????.dat files (since 0.8) */
 static const unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
@@ -114,6 +124,20 @@ private:
      */
     void FindFilesToPrune(std::set<int>& setFilesToPrune, uint64_t nPruneAfterHeight, int chain_tip_height, int prune_height, bool is_ibd);
 
+    //! Unset HAVE_DATA and HAVE_UNDO for one block whose data is being removed
+    void PruneOneBlock(CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    //! Copy a stored block and its undo data to the end of the current block and undo files
+    bool RelocateBlock(CBlockIndex* pindex, CChain& active_chain, std::set<int>& undo_files) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    /** A range of a block or undo file holding data that has been pruned. */
+    struct PrunedRange {
+        int file;
+        bool undo;
+        unsigned int pos;
+        unsigned int length;
+    };
+
     RecursiveMutex cs_LastBlockFile;
     std::vector<CBlockFileInfo> m_blockfile_info;
     int m_last_blockfile = 0;
@@ -131,6 +155,27 @@ private:
     /** Dirty block file entries. */
     std::set<int> m_dirty_fileinfo;
 
+    /** Ranges queued by CompactBlockFiles() to be deallocated once the block index no longer refers to them. */
+    std::vector<PrunedRange> m_pending_hole_punches;
+
+    /** Bytes deallocated from block and undo files that are still in use, by file number. */
+    std::map<int, uint64_t> m_blockfile_punched;
+
+    /**
+     * Sizes of the block and undo records CompactBlockFiles() looked at, by
+     * file number and by whether they are undo records and their position, so
+     * that every prune check does not open a file per block again.
+     */
+    std::map<int, std::map<std::pair<bool, unsigned int>, unsigned int>> m_record_sizes;
+
+    /** Size of the block or undo record at `pos`, including its header, from m_record_sizes or the file */
+    std::optional<unsigned int> RecordSize(const FlatFilePos& pos, bool undo) EXCLUSIVE_LOCKS_REQUIRED(cs_LastBlockFile);
+
+    /** Bytes of block and undo files reclaimed by compaction since startup. */
+    uint64_t m_reclaimed_bytes{0};
+
+    bool m_punch_holes_supported{true};
+
     /**
      * Map from external index name to oldest block that must not be pruned.
      *
@@ -179,6 +224,31 @@ public:
     //! Mark one block file as pruned (modify associated database entries)
     void PruneOneBlockFile(const int fileNumber) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /**
+     * Compact the block files that FindFilesToPrune() keeps because some of
+     * their blocks are recent, while the disk space used is above the prune
+     * target. Blocks at or above the last height that can be pruned are dead.
+     *
+     * With -prunecompact, the live blocks of files that are mostly dead are
+     * copied with their undo data to the current block file, and the old files
+     * are pruned as a whole and added to `setFilesToPrune`. With
+     * -prunepunchholes, the dead blocks of the other files are pruned, and
+     * their ranges are queued to be deallocated by PunchPrunedHoles().
+     */
+    void CompactBlockFiles(std::set<int>& setFilesToPrune, CChain& active_chain, int prune_height) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+    /** Whether CompactBlockFiles() queued ranges that PunchPrunedHoles() has not deallocated yet. */
+    bool HavePendingHolePunches();
+
+    /**
+     * Deallocate the ranges queued by CompactBlockFiles(). Must only be called
+     * after the block index that no longer refers to them has been written.
+     */
+    void PunchPrunedHoles();
+
+    /** Bytes of block and undo files reclaimed by compaction since startup. */
+    uint64_t GetReclaimedBytes();
+
     CBlockIndex* LookupBlockIndex(const uint256& hash) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     const CBlockIndex* LookupBlockIndex(const uint256& hash) const EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
@@ -196,6 +266,8 @@ public:
 
     /** Attempt to stay below this number of bytes of block files. */
     [[nodiscard]] uint64_t GetPruneTarget() const { return m_opts.prune_target; }
+    //! Number of threads scanning and reading block files during -reindex (0 reindexes serially)
+    [[nodiscard]] int GetReindexThreads() const { return m_opts.reindex_threads; }
     static constexpr auto PRUNE_TARGET_MANUAL{std::numeric_limits<uint64_t>::max()};
 
     [[nodiscard]] bool LoadingBlocks() const { return m_importing || fReindex; }
@@ -227,16 +299,56 @@ FILE* OpenBlockFile(const FlatFilePos& pos, bool fReadOnly = false);
 fs::path GetBlockPosFilename(const FlatFilePos& pos);
 
 /**
- *  Actually unlink the specified files
+ *  Actually unlink the specified files. Files a BlockFileReadGuard is held
+ *  for are unlinked when the last of them is released.
  */
 void UnlinkPrunedFiles(const std::set<int>& setFilesToPrune);
 
+/**
+ * Keeps a block file and its undo file readable while held: pruning defers
+ * unlinking them, or deallocating ranges of them, until the last guard of the
+ * file is released. Readers take one under cs_main together with the position
+ * of a block, so that the data stays at that position even when the block is
+ * pruned or relocated before they read it.
+ */
+class BlockFileReadGuard
+{
+public:
+    explicit BlockFileReadGuard(int file);
+    ~BlockFileReadGuard();
+    BlockFileReadGuard(const BlockFileReadGuard&) = delete;
+    BlockFileReadGuard& operator=(const BlockFileReadGuard&) = delete;
+
+private:
+    const int m_file;
+};
+
+/** Whether a BlockFileReadGuard of the file is held */
+bool IsBlockFileRead(int file);
+
 /** Functions for disk access for blocks */
 bool ReadBlockFromDisk(CBlock& block, const FlatFilePos& pos, const Consensus::Params& consensusParams);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex, const Consensus::Params& consensusParams);
 bool ReadRawBlockFromDisk(std::vector<uint8_t>& block, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start);
 
 bool UndoReadFromDisk(CBlockUndo& blockundo, const CBlockIndex* pindex);
+/** Read the undo data at `pos` of the block whose parent is `prev_hash`. Does not lock cs_main. */
+bool UndoReadFromDisk(CBlockUndo& blockundo, const FlatFilePos& pos, const uint256& prev_hash);
+
+/** A block located in a block file by ScanBlockFile(), before it is deserialized. */
+struct ScannedBlock {
+    CBlockHeader header;
+    uint256 hash;
+    FlatFilePos pos;
+};
+
+/**
+ * Locate the blocks stored in block file `file_number`. Only the headers are
+ * parsed, and data that does not look like a block with valid proof of work
+ * is skipped, the same way LoadExternalBlockFile() skips it. Safe to call for
+ * several files in parallel.
+ */
+std::vector<ScannedBlock> ScanBlockFile(int file_number, const CChainParams& params);
 
 void ThreadImport(ChainstateManager& chainman, std::vector<fs::path> vImportFiles, const ArgsManager& args, const fs::path& mempool_path);
 } // namespace node
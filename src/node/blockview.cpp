@@ -0,0 +1,377 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/blockview.h>
+
+#include <chain.h>
+#include <clientversion.h>
+#include <crypto/common.h>
+#include <flatfile.h>
+#include <hash.h>
+#include <logging.h>
+#include <node/blockstorage.h>
+#include <serialize.h>
+#include <streams.h>
+#include <sync.h>
+#include <util/strencodings.h>
+
+#include <cstring>
+#include <ios>
+#include <list>
+#include <utility>
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace node {
+namespace {
+/** Read a compact size from the front of `data`, advancing it. */
+uint64_t TakeCompactSize(Span<const uint8_t>& data)
+{
+    SpanReader reader{SER_DISK, CLIENT_VERSION, data};
+    const uint64_t n{::ReadCompactSize(reader)};
+    data = data.last(reader.size());
+    return n;
+}
+
+/** Split `len` bytes off the front of `data`. */
+Span<const uint8_t> Take(Span<const uint8_t>& data, uint64_t len)
+{
+    if (len > data.size()) throw std::ios_base::failure("BlockView: unexpected end of data");
+    Span<const uint8_t> head{data.first(len)};
+    data = data.subspan(len);
+    return head;
+}
+
+/** Skip `count` serialized elements of type V at the front of `data`. */
+template <typename V>
+void Skip(Span<const uint8_t>& data, uint64_t count)
+{
+    V element;
+    for (uint64_t i = 0; i < count; ++i) {
+        data = data.subspan(V::Parse(data, element));
+    }
+}
+
+Mutex g_mapped_files_mutex;
+//! Most recently used mappings first.
+std::list<std::pair<int, std::shared_ptr<const MappedBlockFile>>> g_mapped_files GUARDED_BY(g_mapped_files_mutex);
+
+/** Return a mapping of the file that covers at least `min_size` bytes, reusing a cached one if possible. */
+std::shared_ptr<const MappedBlockFile> GetMappedBlockFile(int file_number, size_t min_size)
+{
+    LOCK(g_mapped_files_mutex);
+    for (auto it{g_mapped_files.begin()}; it != g_mapped_files.end(); ++it) {
+        if (it->first != file_number) continue;
+        if (it->second->Data().size() >= min_size) {
+            g_mapped_files.splice(g_mapped_files.begin(), g_mapped_files, it);
+            return g_mapped_files.front().second;
+        }
+        // The file has grown since it was mapped; map it again.
+        g_mapped_files.erase(it);
+        break;
+    }
+    auto mapped{MappedBlockFile::Open(file_number)};
+    if (!mapped || mapped->Data().size() < min_size) return nullptr;
+    g_mapped_files.emplace_front(file_number, mapped);
+    if (g_mapped_files.size() > MAX_MAPPED_BLOCK_FILES) g_mapped_files.pop_back();
+    return mapped;
+}
+} // namespace
+
+std::shared_ptr<const MappedBlockFile> MappedBlockFile::Open(int file_number)
+{
+    const fs::path path{GetBlockPosFilename(FlatFilePos{file_number, 0})};
+#ifdef WIN32
+    HANDLE file{CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                            nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr)};
+    if (file == INVALID_HANDLE_VALUE) return nullptr;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return nullptr;
+    }
+    HANDLE mapping{CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)};
+    CloseHandle(file);
+    if (mapping == nullptr) return nullptr;
+    void* data{MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)};
+    CloseHandle(mapping);
+    if (data == nullptr) return nullptr;
+    return std::shared_ptr<const MappedBlockFile>{new MappedBlockFile{static_cast<const uint8_t*>(data), static_cast<size_t>(size.QuadPart)}};
+#else
+    const int fd{open(fs::PathToString(path).c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd < 0) return nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+    void* data{mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0)};
+    close(fd);
+    if (data == MAP_FAILED) return nullptr;
+    return std::shared_ptr<const MappedBlockFile>{new MappedBlockFile{static_cast<const uint8_t*>(data), static_cast<size_t>(st.st_size)}};
+#endif
+}
+
+MappedBlockFile::~MappedBlockFile()
+{
+#ifdef WIN32
+    UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+#endif
+}
+
+void UnmapBlockFile(int file_number)
+{
+    LOCK(g_mapped_files_mutex);
+    g_mapped_files.remove_if([&](const auto& entry) { return entry.first == file_number; });
+}
+
+CAmount TxOutView::Value() const
+{
+    return static_cast<CAmount>(ReadLE64(m_value.data()));
+}
+
+CTxOut TxOutView::ToTxOut() const
+{
+    return CTxOut{Value(), CScript(m_script.begin(), m_script.end())};
+}
+
+size_t TxOutView::Parse(Span<const uint8_t> data, TxOutView& out)
+{
+    const size_t total{data.size()};
+    out.m_value = Take(data, 8);
+    out.m_script = Take(data, TakeCompactSize(data));
+    return total - data.size();
+}
+
+COutPoint TxInView::Prevout() const
+{
+    return COutPoint{uint256{m_prevout.first(32)}, ReadLE32(m_prevout.data() + 32)};
+}
+
+uint32_t TxInView::Sequence() const
+{
+    return ReadLE32(m_sequence.data());
+}
+
+size_t TxInView::Parse(Span<const uint8_t> data, TxInView& in)
+{
+    const size_t total{data.size()};
+    in.m_prevout = Take(data, 36);
+    in.m_script_sig = Take(data, TakeCompactSize(data));
+    in.m_sequence = Take(data, 4);
+    return total - data.size();
+}
+
+size_t TxView::Parse(Span<const uint8_t> data, TxView& tx)
+{
+    // Mirrors UnserializeTransaction() with witness serialization allowed.
+    const Span<const uint8_t> start{data};
+    Take(data, 4); // nVersion
+    Span<const uint8_t> body{data};
+    uint8_t flags{0};
+    tx.m_input_count = TakeCompactSize(data);
+    if (tx.m_input_count == 0) {
+        // Either the extended format marker, or a transaction without inputs and outputs.
+        flags = Take(data, 1)[0];
+        if (flags != 0) {
+            body = data;
+            tx.m_input_count = TakeCompactSize(data);
+            tx.m_inputs = data;
+            Skip<TxInView>(data, tx.m_input_count);
+            tx.m_inputs = tx.m_inputs.first(tx.m_inputs.size() - data.size());
+            tx.m_output_count = TakeCompactSize(data);
+            tx.m_outputs = data;
+            Skip<TxOutView>(data, tx.m_output_count);
+            tx.m_outputs = tx.m_outputs.first(tx.m_outputs.size() - data.size());
+        } else {
+            tx.m_output_count = 0;
+        }
+    } else {
+        tx.m_inputs = data;
+        Skip<TxInView>(data, tx.m_input_count);
+        tx.m_inputs = tx.m_inputs.first(tx.m_inputs.size() - data.size());
+        tx.m_output_count = TakeCompactSize(data);
+        tx.m_outputs = data;
+        Skip<TxOutView>(data, tx.m_output_count);
+        tx.m_outputs = tx.m_outputs.first(tx.m_outputs.size() - data.size());
+    }
+    tx.m_body = body.first(body.size() - data.size());
+    tx.m_has_witness = false;
+    if (flags & 1) {
+        flags ^= 1;
+        for (uint64_t i = 0; i < tx.m_input_count; ++i) {
+            const uint64_t stack_size{TakeCompactSize(data)};
+            for (uint64_t j = 0; j < stack_size; ++j) {
+                const uint64_t item_size{TakeCompactSize(data)};
+                if (item_size) tx.m_has_witness = true;
+                Take(data, item_size);
+            }
+        }
+        if (!tx.m_has_witness) {
+            throw std::ios_base::failure("Superfluous witness record");
+        }
+    }
+    if (flags) {
+        throw std::ios_base::failure("Unknown transaction optional data");
+    }
+    Take(data, 4); // nLockTime
+    tx.m_raw = start.first(start.size() - data.size());
+    return tx.m_raw.size();
+}
+
+uint256 TxView::GetHash() const
+{
+    HashWriter hasher{};
+    hasher.write(AsBytes(m_raw.first(4)));
+    hasher.write(AsBytes(m_body));
+    hasher.write(AsBytes(m_raw.last(4)));
+    return hasher.GetHash();
+}
+
+uint256 TxView::GetWitnessHash() const
+{
+    if (!m_has_witness) return GetHash();
+    HashWriter hasher{};
+    hasher.write(AsBytes(m_raw));
+    return hasher.GetHash();
+}
+
+bool TxView::IsCoinBase() const
+{
+    return m_input_count == 1 && Inputs().begin()->Prevout().IsNull();
+}
+
+CTransactionRef TxView::ToTransaction() const
+{
+    SpanReader reader{SER_DISK, CLIENT_VERSION, m_raw};
+    CMutableTransaction tx;
+    reader >> tx;
+    return MakeTransactionRef(std::move(tx));
+}
+
+CBlockHeader BlockView::GetHeader() const
+{
+    SpanReader reader{SER_DISK, CLIENT_VERSION, m_raw.first(80)};
+    CBlockHeader header;
+    reader >> header;
+    return header;
+}
+
+uint256 BlockView::GetHash() const
+{
+    HashWriter hasher{};
+    hasher.write(AsBytes(m_raw.first(80)));
+    return hasher.GetHash();
+}
+
+CBlock BlockView::ToBlock() const
+{
+    SpanReader reader{SER_DISK, CLIENT_VERSION, m_raw};
+    CBlock block;
+    reader >> block;
+    return block;
+}
+
+BlockView BlockView::FromBytes(Span<const uint8_t> raw, std::shared_ptr<const void> keepalive)
+{
+    BlockView view;
+    view.m_keepalive = std::move(keepalive);
+    view.m_raw = raw;
+    Span<const uint8_t> data{raw};
+    Take(data, 80);
+    view.m_tx_count = TakeCompactSize(data);
+    view.m_txs = data;
+    return view;
+}
+
+/** Map the block at `pos`, keeping `guard` alive along with the view. */
+static bool ReadBlockView(BlockView& view, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start, std::shared_ptr<const void> guard)
+{
+    if (pos.IsNull() || pos.nPos < BLOCK_SERIALIZATION_HEADER_SIZE) {
+        return error("%s: Invalid block position %s", __func__, pos.ToString());
+    }
+    auto mapped{GetMappedBlockFile(pos.nFile, pos.nPos)};
+    if (!mapped) {
+        return error("%s: Failed to map block file for %s", __func__, pos.ToString());
+    }
+    // Each block is preceded by the network magic and its serialized size.
+    const uint8_t* meta{mapped->Data().data() + pos.nPos - BLOCK_SERIALIZATION_HEADER_SIZE};
+    if (memcmp(meta, message_start, CMessageHeader::MESSAGE_START_SIZE)) {
+        return error("%s: Block magic mismatch for %s: %s versus expected %s", __func__, pos.ToString(),
+                     HexStr(Span{meta, CMessageHeader::MESSAGE_START_SIZE}), HexStr(message_start));
+    }
+    const uint32_t blk_size{ReadLE32(meta + CMessageHeader::MESSAGE_START_SIZE)};
+    if (blk_size > MAX_SIZE) {
+        return error("%s: Block data is larger than maximum deserialization size for %s: %s versus %s", __func__, pos.ToString(),
+                     blk_size, MAX_SIZE);
+    }
+    const size_t end{size_t{pos.nPos} + blk_size};
+    if (end > mapped->Data().size()) {
+        mapped = GetMappedBlockFile(pos.nFile, end);
+        if (!mapped) {
+            return error("%s: Block data extends past the end of the file for %s", __func__, pos.ToString());
+        }
+    }
+    try {
+        std::shared_ptr<const void> keepalive{mapped};
+        if (guard) keepalive = std::make_shared<std::pair<std::shared_ptr<const void>, std::shared_ptr<const void>>>(mapped, std::move(guard));
+        view = BlockView::FromBytes(mapped->Data().subspan(pos.nPos, blk_size), std::move(keepalive));
+    } catch (const std::exception& e) {
+        return error("%s: Deserialize error - %s at %s", __func__, e.what(), pos.ToString());
+    }
+    return true;
+}
+
+bool ReadBlockView(BlockView& view, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start)
+{
+    return ReadBlockView(view, pos, message_start, /*guard=*/nullptr);
+}
+
+bool ReadBlockView(BlockView& view, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start)
+{
+    FlatFilePos block_pos;
+    std::shared_ptr<const BlockFileReadGuard> guard;
+    {
+        LOCK(cs_main);
+        block_pos = pindex->GetBlockPos();
+        guard = std::make_shared<const BlockFileReadGuard>(block_pos.nFile);
+    }
+    // The view keeps the guard, so that the mapped block is not deallocated while it is used.
+    if (!ReadBlockView(view, block_pos, message_start, std::move(guard))) {
+        return false;
+    }
+    if (view.GetHash() != pindex->GetBlockHash()) {
+        return error("%s: GetHash() doesn't match index for %s at %s", __func__,
+                     pindex->ToString(), block_pos.ToString());
+    }
+    return true;
+}
+
+ReadRawBlockResult ReadRawBlock(BlockView& view, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start)
+{
+    if (!ReadBlockView(view, pindex, message_start)) return ReadRawBlockResult::NOT_FOUND;
+    try {
+        const uint8_t* end{view.Raw().data() + view.TxOffset()};
+        for (const TxView& tx : view.Transactions()) {
+            end = tx.Raw().data() + tx.Raw().size();
+        }
+        if (end != view.Raw().data() + view.Raw().size()) {
+            throw std::ios_base::failure("trailing data after the last transaction");
+        }
+    } catch (const std::exception& e) {
+        LogPrintf("%s: Deserialize error - %s for block %s\n", __func__, e.what(), pindex->GetBlockHash().ToString());
+        return ReadRawBlockResult::CORRUPTED;
+    }
+    return ReadRawBlockResult::OK;
+}
+} // namespace node
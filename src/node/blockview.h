@@ -0,0 +1,233 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_BLOCKVIEW_H
+#define BITCOIN_NODE_BLOCKVIEW_H
+
+#include <consensus/amount.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <protocol.h>
+#include <span.h>
+#include <uint256.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+class CBlockIndex;
+struct FlatFilePos;
+
+namespace node {
+/** Maximum number of block files kept memory-mapped at the same time. */
+static constexpr size_t MAX_MAPPED_BLOCK_FILES{8};
+
+/**
+ * A read-only mapping of a blk?????.dat file. Mappings are shared between
+ * all views into the file and stay valid for as long as any view exists, even
+ * if the file is pruned in the meantime.
+ */
+class MappedBlockFile
+{
+public:
+    /** Map the block file `file_number`, or return nullptr on failure. */
+    static std::shared_ptr<const MappedBlockFile> Open(int file_number);
+
+    ~MappedBlockFile();
+    MappedBlockFile(const MappedBlockFile&) = delete;
+    MappedBlockFile& operator=(const MappedBlockFile&) = delete;
+
+    Span<const uint8_t> Data() const { return {m_data, m_size}; }
+
+private:
+    MappedBlockFile(const uint8_t* data, size_t size) : m_data{data}, m_size{size} {}
+
+    const uint8_t* m_data;
+    size_t m_size;
+};
+
+/** Lazy view of a serialized transaction output. */
+class TxOutView
+{
+public:
+    CAmount Value() const;
+    Span<const uint8_t> Script() const { return m_script; }
+    CTxOut ToTxOut() const;
+
+    /** Parse one output from the front of `data`; returns the number of bytes consumed. */
+    static size_t Parse(Span<const uint8_t> data, TxOutView& out);
+
+private:
+    Span<const uint8_t> m_value;
+    Span<const uint8_t> m_script;
+};
+
+/** Lazy view of a serialized transaction input. */
+class TxInView
+{
+public:
+    COutPoint Prevout() const;
+    Span<const uint8_t> ScriptSig() const { return m_script_sig; }
+    uint32_t Sequence() const;
+
+    /** Parse one input from the front of `data`; returns the number of bytes consumed. */
+    static size_t Parse(Span<const uint8_t> data, TxInView& in);
+
+private:
+    Span<const uint8_t> m_prevout;
+    Span<const uint8_t> m_script_sig;
+    Span<const uint8_t> m_sequence;
+};
+
+/** A sequence of `count` serialized elements of type V, parsed on iteration. */
+template <typename V>
+class ViewRange
+{
+public:
+    class iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using value_type = V;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const V*;
+        using reference = const V&;
+
+        iterator() = default;
+        iterator(Span<const uint8_t> data, uint64_t remaining) : m_data{data}, m_remaining{remaining} { Load(); }
+
+        reference operator*() const { return m_value; }
+        pointer operator->() const { return &m_value; }
+        iterator& operator++()
+        {
+            m_data = m_data.subspan(m_size);
+            --m_remaining;
+            Load();
+            return *this;
+        }
+        bool operator==(const iterator& other) const { return m_remaining == other.m_remaining; }
+        bool operator!=(const iterator& other) const { return !(*this == other); }
+
+    private:
+        void Load()
+        {
+            if (m_remaining > 0) m_size = V::Parse(m_data, m_value);
+        }
+
+        Span<const uint8_t> m_data;
+        uint64_t m_remaining{0};
+        size_t m_size{0};
+        V m_value;
+    };
+
+    ViewRange() = default;
+    ViewRange(Span<const uint8_t> data, uint64_t count) : m_data{data}, m_count{count} {}
+
+    iterator begin() const { return {m_data, m_count}; }
+    iterator end() const { return {}; }
+    uint64_t size() const { return m_count; }
+    bool empty() const { return m_count == 0; }
+
+private:
+    Span<const uint8_t> m_data;
+    uint64_t m_count{0};
+};
+
+/**
+ * Lazy view of a serialized transaction. Parsing only locates the inputs,
+ * outputs and witness data; nothing is copied and nothing is allocated until
+ * ToTransaction() is called.
+ */
+class TxView
+{
+public:
+    /** Raw serialization, including witness data if present. */
+    Span<const uint8_t> Raw() const { return m_raw; }
+    /** Transaction id (hash of the serialization without witness data). */
+    uint256 GetHash() const;
+    /** Witness transaction id (hash of the full serialization). */
+    uint256 GetWitnessHash() const;
+    bool HasWitness() const { return m_has_witness; }
+    bool IsCoinBase() const;
+
+    ViewRange<TxInView> Inputs() const { return {m_inputs, m_input_count}; }
+    ViewRange<TxOutView> Outputs() const { return {m_outputs, m_output_count}; }
+
+    /** Fully deserialize the transaction. */
+    CTransactionRef ToTransaction() const;
+
+    /** Parse one transaction from the front of `data`; returns the number of bytes consumed. */
+    static size_t Parse(Span<const uint8_t> data, TxView& tx);
+
+private:
+    Span<const uint8_t> m_raw;
+    //! Input and output vectors, including their compact size prefixes.
+    Span<const uint8_t> m_body;
+    Span<const uint8_t> m_inputs;
+    Span<const uint8_t> m_outputs;
+    uint64_t m_input_count{0};
+    uint64_t m_output_count{0};
+    bool m_has_witness{false};
+};
+
+/**
+ * Read-only, zero-copy view of a block stored in a blk?????.dat file.
+ *
+ * The view is backed by a shared memory mapping of the block file. The header
+ * is available immediately; transactions are parsed one at a time while
+ * iterating, so callers that only need txids, outputs or raw bytes never pay
+ * for deserializing the whole block into a CBlock.
+ */
+class BlockView
+{
+public:
+    BlockView() = default;
+
+    /** Raw serialized block. */
+    Span<const uint8_t> Raw() const { return m_raw; }
+    CBlockHeader GetHeader() const;
+    uint256 GetHash() const;
+    uint64_t TxCount() const { return m_tx_count; }
+    ViewRange<TxView> Transactions() const { return {m_txs, m_tx_count}; }
+    /** Offset of the first transaction from the start of the block. */
+    size_t TxOffset() const { return m_raw.size() - m_txs.size(); }
+
+    /** Fully deserialize the block. */
+    CBlock ToBlock() const;
+
+    /** Make a view over already-serialized block bytes. The caller keeps them alive. */
+    static BlockView FromBytes(Span<const uint8_t> raw, std::shared_ptr<const void> keepalive = nullptr);
+
+private:
+    std::shared_ptr<const void> m_keepalive;
+    Span<const uint8_t> m_raw;
+    Span<const uint8_t> m_txs;
+    uint64_t m_tx_count{0};
+};
+
+/** Map the block at `pos` and return a view of it. Does not check proof of work. */
+bool ReadBlockView(BlockView& view, const FlatFilePos& pos, const CMessageHeader::MessageStartChars& message_start);
+/** As above, also checking that the block on disk matches `pindex`. */
+bool ReadBlockView(BlockView& view, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
+
+enum class ReadRawBlockResult {
+    OK,
+    NOT_FOUND,
+    //! The block was found, but its transactions do not parse.
+    CORRUPTED,
+};
+
+/**
+ * Read the block of `pindex` to serve its raw bytes. The block hash only
+ * covers the header, so unlike ReadBlockView() this also walks the
+ * transactions, to catch a corrupted block file before its bytes are sent.
+ */
+ReadRawBlockResult ReadRawBlock(BlockView& view, const CBlockIndex* pindex, const CMessageHeader::MessageStartChars& message_start);
+
+/** Drop cached mappings of a block file, e.g. after it was pruned or rewritten. */
+void UnmapBlockFile(int file_number);
+} // namespace node
+
+#endif // BITCOIN_NODE_BLOCKVIEW_H
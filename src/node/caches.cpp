@@ -5,6 +5,7 @@
 
 #include <node/caches.h>
 
+#include <index/scriptindex.h>
 #include <index/txindex.h>
 #include <txdb.h>
 #include <util/system.h>
@@ -20,6 +21,8 @@ CacheSizes CalculateCacheSizes(const ArgsManager& args, size_t n_indexes)
     nTotalCache -= sizes.block_tree_db;
     sizes.tx_index = std::min(nTotalCache / 8, args.GetBoolArg("-txindex", DEFAULT_TXINDEX) ? nMaxTxIndexCache << 20 : 0);
     nTotalCache -= sizes.tx_index;
+    sizes.script_index = std::min(nTotalCache / 8, args.GetBoolArg("-scriptindex", DEFAULT_SCRIPTINDEX) ? max_script_index_cache << 20 : 0);
+    nTotalCache -= sizes.script_index;
     sizes.filter_index = 0;
     if (n_indexes > 0) {
         int64_t max_cache = std::min(nTotalCache / 8, max_filter_index_cache << 20);
@@ -6,6 +6,7 @@
 #include <node/chainstatemanager_args.h>
 
 #include <arith_uint256.h>
+#include <coinsprefetch.h>
 #include <kernel/chainstatemanager_opts.h>
 #include <node/coins_view_args.h>
 #include <node/database_args.h>
@@ -38,6 +39,13 @@ std::optional<bilingual_str> ApplyArgsManOptions(const ArgsManager& args, Chains
 
     if (auto value{args.GetIntArg("-maxtipage")}) opts.max_tip_age = std::chrono::seconds{*value};
 
+    if (auto value{args.GetIntArg("-prefetchthreads")}) {
+        if (*value < 0 || *value > MAX_COINS_PREFETCH_THREADS) {
+            return strprintf(Untranslated("-prefetchthreads must be between 0 and %d"), MAX_COINS_PREFETCH_THREADS);
+        }
+        opts.coins_prefetch_threads = *value;
+    }
+
     ReadDatabaseArgs(args, opts.block_tree_db);
     ReadDatabaseArgs(args, opts.coins_db);
     ReadCoinsViewArgs(args, opts.coins_view);
@@ -14,6 +14,7 @@
 #include <index/blockfilterindex.h>
 #include <index/txindex.h>
 #include <node/blockstorage.h>
+#include <node/blockview.h>
 #include <node/context.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
@@ -35,9 +36,13 @@
 
 #include <univalue.h>
 
+using node::BlockView;
 using node::GetTransaction;
 using node::NodeContext;
 using node::ReadBlockFromDisk;
+using node::ReadBlockView;
+using node::ReadRawBlock;
+using node::ReadRawBlockResult;
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
 static constexpr unsigned int MAX_REST_HEADERS_RESULTS = 2000;
@@ -312,6 +317,29 @@ static bool rest_block(const std::any& context,
 
     }
 
+    if ((rf == RESTResponseFormat::BINARY || rf == RESTResponseFormat::HEX) && RPCSerializationFlags() == 0) {
+        // Blocks are stored in the requested serialization, so serve the
+        // bytes straight from the block file instead of round-tripping them
+        // through a CBlock.
+        BlockView view;
+        switch (ReadRawBlock(view, pblockindex, chainman.GetParams().MessageStart())) {
+        case ReadRawBlockResult::OK:
+            break;
+        case ReadRawBlockResult::NOT_FOUND:
+            return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
+        case ReadRawBlockResult::CORRUPTED:
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, hashStr + " not available (corrupted data)");
+        } // no default case, so the compiler can warn about missing cases
+        if (rf == RESTResponseFormat::BINARY) {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            req->WriteReply(HTTP_OK, AsBytes(view.Raw()));
+        } else {
+            req->WriteHeader("Content-Type", "text/plain");
+            req->WriteReply(HTTP_OK, HexStr(view.Raw()) + "\n");
+        }
+        return true;
+    }
+
     if (!ReadBlockFromDisk(block, pblockindex, chainman.GetParams().GetConsensus())) {
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
@@ -19,11 +19,14 @@
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scriptindex.h>
+#include <key_io.h>
 #include <kernel/coinstats.h>
 #include <logging/timer.h>
 #include <net.h>
 #include <net_processing.h>
 #include <node/blockstorage.h>
+#include <node/blockview.h>
 #include <node/context.h>
 #include <node/transaction.h>
 #include <node/utxo_snapshot.h>
@@ -58,8 +61,11 @@ using kernel::CCoinsStats;
 using kernel::CoinStatsHashType;
 
 using node::BlockManager;
+using node::BlockView;
 using node::NodeContext;
 using node::ReadBlockFromDisk;
+using node::ReadRawBlock;
+using node::ReadRawBlockResult;
 using node::SnapshotMetadata;
 using node::UndoReadFromDisk;
 
@@ -617,6 +623,27 @@ static CBlock GetBlockChecked(BlockManager& blockman, const CBlockIndex* pblocki
     return block;
 }
 
+static BlockView GetBlockViewChecked(ChainstateManager& chainman, const CBlockIndex* pblockindex)
+{
+    BlockView view;
+    {
+        LOCK(cs_main);
+        if (chainman.m_blockman.IsBlockPruned(pblockindex)) {
+            throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
+        }
+    }
+
+    switch (ReadRawBlock(view, pblockindex, chainman.GetParams().MessageStart())) {
+    case ReadRawBlockResult::OK:
+        return view;
+    case ReadRawBlockResult::NOT_FOUND:
+        throw JSONRPCError(RPC_MISC_ERROR, "Block not found on disk");
+    case ReadRawBlockResult::CORRUPTED:
+        throw JSONRPCError(RPC_MISC_ERROR, "Block not available (corrupted data)");
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
 static CBlockUndo GetUndoChecked(BlockManager& blockman, const CBlockIndex* pblockindex)
 {
     CBlockUndo blockUndo;
@@ -757,6 +784,11 @@ static RPCHelpMan getblock()
         }
     }
 
+    if (verbosity <= 0 && RPCSerializationFlags() == 0) {
+        // The block is stored in the requested serialization already.
+        return HexStr(GetBlockViewChecked(chainman, pblockindex).Raw());
+    }
+
     const CBlock block{GetBlockChecked(chainman.m_blockman, pblockindex)};
 
     if (verbosity <= 0)
@@ -1263,6 +1295,7 @@ RPCHelpMan getblockchaininfo()
                 {RPCResult::Type::NUM, "pruneheight", /*optional=*/true, "height of the last block pruned, plus one (only present if pruning is enabled)"},
                 {RPCResult::Type::BOOL, "automatic_pruning", /*optional=*/true, "whether automatic pruning is enabled (only present if pruning is enabled)"},
                 {RPCResult::Type::NUM, "prune_target_size", /*optional=*/true, "the target size used by pruning (only present if automatic pruning is enabled)"},
+                {RPCResult::Type::NUM, "prune_reclaimed_size", /*optional=*/true, "the size of block and undo data reclaimed by -prunecompact and -prunepunchholes since startup (only present if automatic pruning is enabled)"},
                 {RPCResult::Type::STR, "warnings", "any network and blockchain warnings"},
             }},
         RPCExamples{
@@ -1297,6 +1330,7 @@ RPCHelpMan getblockchaininfo()
         obj.pushKV("automatic_pruning",  automatic_pruning);
         if (automatic_pruning) {
             obj.pushKV("prune_target_size", chainman.m_blockman.GetPruneTarget());
+            obj.pushKV("prune_reclaimed_size", chainman.m_blockman.GetReclaimedBytes());
         }
     }
 
@@ -2595,6 +2629,197 @@ static RPCHelpMan getblockfilter()
     };
 }
 
+static CScript ParseScriptParam(const UniValue& param)
+{
+    const std::string& str{param.get_str()};
+    const CTxDestination dest{DecodeDestination(str)};
+    if (IsValidDestination(dest)) {
+        return GetScriptForDestination(dest);
+    }
+    if (IsHex(str)) {
+        const std::vector<unsigned char> data{ParseHex(str)};
+        return CScript(data.begin(), data.end());
+    }
+    throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid address or scriptPubKey: " + str);
+}
+
+static const ScriptIndex& EnsureSyncedScriptIndex()
+{
+    if (!g_script_index) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Requires -scriptindex");
+    }
+    if (!g_script_index->BlockUntilSyncedToCurrentChain()) {
+        throw JSONRPCError(RPC_MISC_ERROR, "The script index is still in the process of being built. Try again later.");
+    }
+    return *g_script_index;
+}
+
+static const RPCArg SCRIPT_PARAM{"script", RPCArg::Type::STR, RPCArg::Optional::NO, "An address or a hex-encoded scriptPubKey"};
+
+static RPCHelpMan getscripthistory()
+{
+    return RPCHelpMan{"getscripthistory",
+                "\nReturns the confirmed transactions that paid to or spent from a script, most recent first.\n"
+                "Requires -scriptindex.\n",
+                {
+                    SCRIPT_PARAM,
+                    {"skip", RPCArg::Type::NUM, RPCArg::Default{0}, "The number of entries to skip"},
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{100}, "The maximum number of entries to return"},
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                            {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                            {RPCResult::Type::STR_HEX, "blockhash", "The hash of the block containing the transaction"},
+                            {RPCResult::Type::STR, "type", "\"receive\" for an output paying to the script, \"spend\" for an input spending one"},
+                            {RPCResult::Type::NUM, "n", "The output index for receives, the input index for spends"},
+                            {RPCResult::Type::STR_AMOUNT, "amount", "The amount received or spent in " + CURRENCY_UNIT},
+                            {RPCResult::Type::OBJ, "prevout", /*optional=*/true, "The output spent, for spends",
+                            {
+                                {RPCResult::Type::STR_HEX, "txid", "The transaction id of the output"},
+                                {RPCResult::Type::NUM, "vout", "The output index"},
+                            }},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getscripthistory", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleCli("getscripthistory", "\"" + EXAMPLE_ADDRESS[0] + "\" 100 50") +
+                    HelpExampleRpc("getscripthistory", "\"" + EXAMPLE_ADDRESS[0] + "\", 100, 50")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseScriptParam(request.params[0])};
+    const int skip{request.params[1].isNull() ? 0 : request.params[1].getInt<int>()};
+    const int count{request.params[2].isNull() ? 100 : request.params[2].getInt<int>()};
+    if (skip < 0 || count < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative skip or count");
+    }
+
+    std::vector<ScriptHistoryEntry> entries;
+    if (!EnsureSyncedScriptIndex().LookupHistory(script, skip, count, entries)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Unable to read the script index");
+    }
+
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    UniValue ret(UniValue::VARR);
+    LOCK(cs_main);
+    for (const ScriptHistoryEntry& entry : entries) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", entry.txid.GetHex());
+        obj.pushKV("height", entry.height);
+        if (const CBlockIndex* block_index{chainman.ActiveChain()[entry.height]}) {
+            obj.pushKV("blockhash", block_index->GetBlockHash().GetHex());
+        }
+        obj.pushKV("type", entry.spend ? "spend" : "receive");
+        obj.pushKV("n", uint64_t{entry.n});
+        obj.pushKV("amount", ValueFromAmount(entry.amount));
+        if (entry.spend) {
+            UniValue prevout(UniValue::VOBJ);
+            prevout.pushKV("txid", entry.prevout.hash.GetHex());
+            prevout.pushKV("vout", uint64_t{entry.prevout.n});
+            obj.pushKV("prevout", prevout);
+        }
+        ret.push_back(obj);
+    }
+    return ret;
+},
+    };
+}
+
+static RPCHelpMan getscriptutxos()
+{
+    return RPCHelpMan{"getscriptutxos",
+                "\nReturns the confirmed unspent outputs paying to a script.\n"
+                "Requires -scriptindex.\n",
+                {
+                    SCRIPT_PARAM,
+                    {"skip", RPCArg::Type::NUM, RPCArg::Default{0}, "The number of outputs to skip"},
+                    {"count", RPCArg::Type::NUM, RPCArg::Default{100}, "The maximum number of outputs to return"},
+                },
+                RPCResult{
+                    RPCResult::Type::ARR, "", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                            {RPCResult::Type::NUM, "vout", "The output index"},
+                            {RPCResult::Type::NUM, "height", "The height of the block containing the transaction"},
+                            {RPCResult::Type::STR_AMOUNT, "amount", "The amount in " + CURRENCY_UNIT},
+                            {RPCResult::Type::BOOL, "coinbase", "Whether the output was created by a coinbase transaction"},
+                        }},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getscriptutxos", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleRpc("getscriptutxos", "\"" + EXAMPLE_ADDRESS[0] + "\", 0, 10")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseScriptParam(request.params[0])};
+    const int skip{request.params[1].isNull() ? 0 : request.params[1].getInt<int>()};
+    const int count{request.params[2].isNull() ? 100 : request.params[2].getInt<int>()};
+    if (skip < 0 || count < 0) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Negative skip or count");
+    }
+
+    std::vector<ScriptUtxo> utxos;
+    if (!EnsureSyncedScriptIndex().LookupUtxos(script, skip, count, utxos)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Unable to read the script index");
+    }
+
+    UniValue ret(UniValue::VARR);
+    for (const ScriptUtxo& utxo : utxos) {
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("txid", utxo.outpoint.hash.GetHex());
+        obj.pushKV("vout", uint64_t{utxo.outpoint.n});
+        obj.pushKV("height", utxo.height);
+        obj.pushKV("amount", ValueFromAmount(utxo.amount));
+        obj.pushKV("coinbase", utxo.coinbase);
+        ret.push_back(obj);
+    }
+    return ret;
+},
+    };
+}
+
+static RPCHelpMan getscriptbalance()
+{
+    return RPCHelpMan{"getscriptbalance",
+                "\nReturns the sum of the confirmed unspent outputs paying to a script.\n"
+                "Requires -scriptindex.\n",
+                {
+                    SCRIPT_PARAM,
+                },
+                RPCResult{
+                    RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_AMOUNT, "balance", "The total amount in " + CURRENCY_UNIT},
+                        {RPCResult::Type::NUM, "utxos", "The number of unspent outputs"},
+                    }},
+                RPCExamples{
+                    HelpExampleCli("getscriptbalance", "\"" + EXAMPLE_ADDRESS[0] + "\"") +
+                    HelpExampleRpc("getscriptbalance", "\"" + EXAMPLE_ADDRESS[0] + "\"")
+                },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    const CScript script{ParseScriptParam(request.params[0])};
+
+    CAmount balance;
+    uint64_t utxo_count;
+    if (!EnsureSyncedScriptIndex().LookupBalance(script, balance, utxo_count)) {
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Unable to read the script index");
+    }
+
+    UniValue ret(UniValue::VOBJ);
+    ret.pushKV("balance", ValueFromAmount(balance));
+    ret.pushKV("utxos", utxo_count);
+    return ret;
+},
+    };
+}
+
 /**
  * Serialize the UTXO set to a file for loading elsewhere.
  *
@@ -2753,6 +2978,9 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &scantxoutset},
         {"blockchain", &scanblocks},
         {"blockchain", &getblockfilter},
+        {"blockchain", &getscripthistory},
+        {"blockchain", &getscriptutxos},
+        {"blockchain", &getscriptbalance},
         {"hidden", &invalidateblock},
         {"hidden", &reconsiderblock},
         {"hidden", &waitfornewblock},
@@ -92,6 +92,10 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "scanblocks", 2, "start_height" },
     { "scanblocks", 3, "stop_height" },
     { "scanblocks", 5, "options" },
+    { "getscripthistory", 1, "skip" },
+    { "getscripthistory", 2, "count" },
+    { "getscriptutxos", 1, "skip" },
+    { "getscriptutxos", 2, "count" },
     { "scantxoutset", 1, "scanobjects" },
     { "addmultisigaddress", 0, "nrequired" },
     { "addmultisigaddress", 1, "keys" },
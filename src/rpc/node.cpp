@@ -8,6 +8,7 @@
 #include <httpserver.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scriptindex.h>
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <interfaces/echo.h>
@@ -368,6 +369,9 @@ static UniValue SummaryToJSON(const IndexSummary&& summary, std::string index_na
     UniValue entry(UniValue::VOBJ);
     entry.pushKV("synced", summary.synced);
     entry.pushKV("best_block_height", summary.best_block_height);
+    entry.pushKV("sync_threads", summary.sync_threads);
+    entry.pushKV("synced_blocks", summary.synced_blocks);
+    entry.pushKV("sync_blocks_per_second", summary.sync_blocks_per_second);
     ret_summary.pushKV(summary.name, entry);
     return ret_summary;
 }
@@ -386,6 +390,9 @@ static RPCHelpMan getindexinfo()
                             {
                                 {RPCResult::Type::BOOL, "synced", "Whether the index is synced or not"},
                                 {RPCResult::Type::NUM, "best_block_height", "The block height to which the index is synced"},
+                                {RPCResult::Type::NUM, "sync_threads", "The number of threads used by the background sync (0 if serial)"},
+                                {RPCResult::Type::NUM, "synced_blocks", "The number of blocks indexed by the background sync since startup"},
+                                {RPCResult::Type::NUM, "sync_blocks_per_second", "The average rate of the background sync since startup"},
                             }
                         },
                     },
@@ -409,6 +416,10 @@ static RPCHelpMan getindexinfo()
         result.pushKVs(SummaryToJSON(g_coin_stats_index->GetSummary(), index_name));
     }
 
+    if (g_script_index) {
+        result.pushKVs(SummaryToJSON(g_script_index->GetSummary(), index_name));
+    }
+
     ForEachBlockFilterIndex([&result, &index_name](const BlockFilterIndex& index) {
         result.pushKVs(SummaryToJSON(index.GetSummary(), index_name));
     });
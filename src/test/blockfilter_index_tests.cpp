@@ -13,6 +13,8 @@
 #include <pow.h>
 #include <script/standard.h>
 #include <test/util/blockfilter.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
 #include <test/util/setup_common.h>
 #include <util/time.h>
 #include <validation.h>
@@ -311,4 +313,42 @@ BOOST_FIXTURE_TEST_CASE(blockfilter_index_init_destroy, BasicTestingSetup)
     BOOST_CHECK(filter_index == nullptr);
 }
 
+BOOST_FIXTURE_TEST_CASE(blockfilter_index_parallel_initial_sync, RegTestingSetup)
+{
+    for (int i = 0; i < 30; ++i) {
+        MineBlock(m_node, P2WSH_OP_TRUE);
+    }
+
+    for (const int threads : {0, 4}) {
+        gArgs.ForceSetArg("-indexthreads", ToString(threads));
+        BlockFilterIndex filter_index(interfaces::MakeChain(m_node), BlockFilterType::BASIC, 1 << 20, true, true);
+        BOOST_REQUIRE(filter_index.Start());
+
+        constexpr int64_t timeout_ms = 10 * 1000;
+        int64_t time_start = GetTimeMillis();
+        while (!filter_index.BlockUntilSyncedToCurrentChain()) {
+            BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+            UninterruptibleSleep(std::chrono::milliseconds{100});
+        }
+        BOOST_CHECK_EQUAL(filter_index.GetSummary().sync_threads, threads);
+        BOOST_CHECK_EQUAL(filter_index.GetSummary().synced_blocks, 31U);
+
+        // Filter headers chain up from genesis as if the blocks were indexed one by one.
+        uint256 last_header;
+        LOCK(cs_main);
+        for (const CBlockIndex* block_index = m_node.chainman->ActiveChain().Genesis();
+             block_index != nullptr;
+             block_index = m_node.chainman->ActiveChain().Next(block_index)) {
+            BlockFilter expected_filter, filter;
+            uint256 filter_header;
+            BOOST_REQUIRE(ComputeFilter(filter_index.GetFilterType(), block_index, expected_filter));
+            BOOST_REQUIRE(filter_index.LookupFilter(block_index, filter));
+            BOOST_REQUIRE(filter_index.LookupFilterHeader(block_index, filter_header));
+            BOOST_CHECK_EQUAL(filter.GetHash(), expected_filter.GetHash());
+            BOOST_CHECK_EQUAL(filter_header, expected_filter.ComputeHeader(last_header));
+            last_header = filter_header;
+        }
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
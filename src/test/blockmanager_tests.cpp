@@ -4,17 +4,86 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <chainparams.h>
+#include <consensus/validation.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
+#include <pow.h>
+#include <streams.h>
+#include <undo.h>
 #include <validation.h>
 
 #include <boost/test/unit_test.hpp>
 #include <test/util/setup_common.h>
 
+using node::BlockFileReadGuard;
 using node::BlockManager;
+using node::GetBlockPosFilename;
 using node::BLOCK_SERIALIZATION_HEADER_SIZE;
 using node::MAX_BLOCKFILE_SIZE;
 using node::OpenBlockFile;
+using node::ReadBlockFromDisk;
+using node::ReadRawBlockFromDisk;
+using node::ScanBlockFile;
+using node::ScannedBlock;
+using node::UndoReadFromDisk;
+using node::UnlinkPrunedFiles;
+
+namespace {
+/**
+ * A chain of MIN_BLOCKS_TO_KEEP + 12 headers on top of the regtest genesis
+ * block, whose blocks are only stored on disk by Store().
+ */
+struct CompactionChain {
+    std::unique_ptr<const CChainParams> params{CreateChainParams(ArgsManager{}, CBaseChainParams::REGTEST)};
+    BlockManager& blockman;
+    CChain chain{};
+    std::vector<CBlockIndex*> index;
+    std::map<const CBlockIndex*, CBlock> blocks;
+
+    explicit CompactionChain(BlockManager& blockman_in) EXCLUSIVE_LOCKS_REQUIRED(cs_main) : blockman{blockman_in}
+    {
+        CBlockIndex* best_header{nullptr};
+        CBlockHeader header{params->GenesisBlock().GetBlockHeader()};
+        index.push_back(blockman.AddToBlockIndex(header, best_header));
+        for (unsigned int i = 0; i < MIN_BLOCKS_TO_KEEP + 12; ++i) {
+            header.hashPrevBlock = index.back()->GetBlockHash();
+            header.nNonce = i;
+            index.push_back(blockman.AddToBlockIndex(header, best_header));
+        }
+        chain.SetTip(*index.back());
+    }
+
+    /** Store the `i`th block with `padding` bytes of coinbase output, and empty undo data. */
+    void Store(size_t i, size_t padding) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+    {
+        CBlockIndex* pindex{index.at(i)};
+        CMutableTransaction coinbase;
+        coinbase.vin.resize(1);
+        coinbase.vout.emplace_back(0, CScript{} << OP_RETURN << std::vector<unsigned char>(padding, 0x01));
+        CBlock& block{blocks[pindex]};
+        static_cast<CBlockHeader&>(block) = pindex->GetBlockHeader();
+        block.vtx = {MakeTransactionRef(std::move(coinbase))};
+
+        const FlatFilePos pos{blockman.SaveBlockToDisk(block, pindex->nHeight, chain, *params, nullptr)};
+        pindex->nFile = pos.nFile;
+        pindex->nDataPos = pos.nPos;
+        pindex->nStatus |= BLOCK_HAVE_DATA;
+        BlockValidationState state;
+        BOOST_REQUIRE(blockman.WriteUndoDataForBlock(CBlockUndo{}, state, pindex, *params));
+    }
+
+    /** Whether the block of `pindex` can be read back from where the index says it is. */
+    bool ReadBack(const CBlockIndex* pindex) EXCLUSIVE_LOCKS_REQUIRED(cs_main)
+    {
+        std::vector<uint8_t> raw;
+        CDataStream expected{SER_DISK, CLIENT_VERSION};
+        expected << blocks.at(pindex);
+        CBlockUndo undo;
+        return ReadRawBlockFromDisk(raw, pindex->GetBlockPos(), params->MessageStart()) &&
+               MakeByteSpan(raw) == MakeByteSpan(expected) && UndoReadFromDisk(undo, pindex);
+    }
+};
+} // namespace
 
 // use BasicTestingSetup here for the data directory configuration, setup, and cleanup
 BOOST_FIXTURE_TEST_SUITE(blockmanager_tests, BasicTestingSetup)
@@ -42,6 +111,160 @@ BOOST_AUTO_TEST_CASE(blockmanager_find_block_pos)
     BOOST_CHECK_EQUAL(actual.nPos, BLOCK_SERIALIZATION_HEADER_SIZE + ::GetSerializeSize(params->GenesisBlock(), CLIENT_VERSION) + BLOCK_SERIALIZATION_HEADER_SIZE);
 }
 
+BOOST_AUTO_TEST_CASE(blockmanager_scan_block_file)
+{
+    const auto params{CreateChainParams(ArgsManager{}, CBaseChainParams::REGTEST)};
+    const CBlock& genesis{params->GenesisBlock()};
+    CBlock child;
+    child.hashPrevBlock = genesis.GetHash();
+    child.nTime = genesis.nTime + 1;
+    child.nBits = genesis.nBits;
+    child.vtx = genesis.vtx;
+    while (!CheckProofOfWork(child.GetHash(), child.nBits, params->GetConsensus())) ++child.nNonce;
+
+    // Lay out a block file the way blocks are stored, with junk in between
+    // that starts like a block but is not one.
+    DataStream stream{};
+    const auto append_block{[&](const CBlock& block) {
+        stream << params->MessageStart() << static_cast<uint32_t>(::GetSerializeSize(block, CLIENT_VERSION));
+        const unsigned int pos{static_cast<unsigned int>(stream.size())};
+        CDataStream block_data{SER_DISK, CLIENT_VERSION};
+        block_data << block;
+        stream << Span{block_data};
+        return pos;
+    }};
+    const unsigned int genesis_pos{append_block(genesis)};
+    stream << params->MessageStart() << uint32_t{200} << std::vector<uint8_t>(200, 0x01);
+    stream << params->MessageStart() << uint32_t{MAX_BLOCKFILE_SIZE};
+    const unsigned int child_pos{append_block(child)};
+    // Block files are pre-allocated with zeroes.
+    stream << std::vector<uint8_t>(1000, 0x00);
+
+    const FlatFilePos file_pos{7, 0};
+    AutoFile{OpenBlockFile(file_pos)} << Span{stream};
+
+    const std::vector<ScannedBlock> blocks{ScanBlockFile(file_pos.nFile, *params)};
+    BOOST_REQUIRE_EQUAL(blocks.size(), 2U);
+    BOOST_CHECK(blocks[0].hash == genesis.GetHash());
+    BOOST_CHECK(blocks[0].pos == FlatFilePos(file_pos.nFile, genesis_pos));
+    BOOST_CHECK(blocks[1].hash == child.GetHash());
+    BOOST_CHECK(blocks[1].header.hashPrevBlock == genesis.GetHash());
+    BOOST_CHECK(blocks[1].pos == FlatFilePos(file_pos.nFile, child_pos));
+
+    // The positions found can be read back as blocks.
+    CBlock block;
+    BOOST_CHECK(ReadBlockFromDisk(block, blocks[1].pos, params->GetConsensus()));
+    BOOST_CHECK(block.GetHash() == child.GetHash());
+
+    // Missing files have no blocks.
+    BOOST_CHECK(ScanBlockFile(file_pos.nFile + 1, *params).empty());
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_compact_block_files)
+{
+    // Use 64kb block files, so that a few padded blocks fill one.
+    gArgs.ForceSetArg("-fastprune", "1");
+    BlockManager blockman{{.prune_target = 1, .prune_compact = true}};
+    LOCK(cs_main);
+    CompactionChain test{blockman};
+
+    // ViceversaChain: the first blocks after genesis have the highest heights
+    // and are old enough to prune, while the tip was stored among them, as
+    // after a reorg.
+    for (size_t i = 1; i <= 4; ++i) test.Store(i, 12000);
+    CBlockIndex* tip{test.index.back()};
+    test.Store(test.index.size() - 1, 12000);
+    CBlockIndex* next_to_tip{test.index.end()[-2]};
+    test.Store(test.index.size() - 2, 30000);
+    BOOST_REQUIRE_EQUAL(tip->nFile, 0);
+    BOOST_REQUIRE_EQUAL(next_to_tip->nFile, 1);
+
+    const uint64_t usage_before{blockman.CalculateCurrentUsage()};
+    std::set<int> files_to_prune;
+    blockman.CompactBlockFiles(files_to_prune, test.chain, /*prune_height=*/0);
+    BOOST_CHECK(files_to_prune == std::set<int>{0});
+
+    // The tip was copied with its undo data, and file 0 only holds blocks
+    // that are pruned now.
+    BOOST_CHECK_EQUAL(tip->nFile, 1);
+    BOOST_CHECK(test.ReadBack(tip));
+    BOOST_CHECK(test.ReadBack(next_to_tip));
+    for (size_t i = 1; i <= 4; ++i) {
+        BOOST_CHECK(!(test.index[i]->nStatus & BLOCK_HAVE_DATA));
+    }
+    BOOST_CHECK_EQUAL(blockman.GetBlockFileInfo(0)->nSize, 0U);
+    BOOST_CHECK_GT(blockman.GetReclaimedBytes(), 0U);
+    BOOST_CHECK_EQUAL(blockman.GetReclaimedBytes(), usage_before - blockman.CalculateCurrentUsage());
+    BOOST_CHECK(!blockman.HavePendingHolePunches());
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_punch_pruned_holes)
+{
+    gArgs.ForceSetArg("-fastprune", "1");
+    BlockManager blockman{{.prune_target = 1, .prune_punch_holes = true}};
+    LOCK(cs_main);
+    CompactionChain test{blockman};
+
+    // Too many live blocks in file 0 to rewrite it, and compaction is off.
+    test.Store(1, 12000);
+    test.Store(test.index.size() - 1, 12000);
+    test.Store(test.index.size() - 2, 12000);
+    test.Store(test.index.size() - 3, 30000);
+    const CBlockIndex* dead{test.index[1]};
+    const FlatFilePos dead_pos{dead->GetBlockPos()};
+    BOOST_REQUIRE_EQUAL(dead_pos.nFile, 0);
+
+    const uint64_t usage_before{blockman.CalculateCurrentUsage()};
+    std::set<int> files_to_prune;
+    blockman.CompactBlockFiles(files_to_prune, test.chain, /*prune_height=*/0);
+    BOOST_CHECK(files_to_prune.empty());
+    BOOST_CHECK(!(dead->nStatus & BLOCK_HAVE_DATA));
+    BOOST_CHECK(blockman.HavePendingHolePunches());
+    BOOST_CHECK_EQUAL(blockman.CalculateCurrentUsage(), usage_before);
+
+    // A reader that took the position of the block before it was pruned can
+    // still read it.
+    {
+        BlockFileReadGuard guard{dead_pos.nFile};
+        blockman.PunchPrunedHoles();
+        BOOST_CHECK(blockman.HavePendingHolePunches());
+        std::vector<uint8_t> raw;
+        BOOST_CHECK(ReadRawBlockFromDisk(raw, dead_pos, test.params->MessageStart()));
+    }
+    blockman.PunchPrunedHoles();
+    BOOST_CHECK(!blockman.HavePendingHolePunches());
+    BOOST_CHECK(test.ReadBack(test.index.end()[-1]));
+    BOOST_CHECK(test.ReadBack(test.index.end()[-2]));
+    // Not every filesystem can deallocate ranges of a file.
+    if (blockman.GetReclaimedBytes() > 0) {
+        BOOST_CHECK_EQUAL(blockman.GetReclaimedBytes(), usage_before - blockman.CalculateCurrentUsage());
+        std::vector<uint8_t> raw(1000);
+        AutoFile{OpenBlockFile(dead_pos, true)} >> MakeWritableByteSpan(raw);
+        BOOST_CHECK(std::all_of(raw.begin(), raw.end(), [](uint8_t b) { return b == 0; }));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(blockmanager_unlink_read_file)
+{
+    gArgs.ForceSetArg("-fastprune", "1");
+    BlockManager blockman{{.prune_target = 1}};
+    LOCK(cs_main);
+    CompactionChain test{blockman};
+    test.Store(1, 12000);
+    const FlatFilePos pos{test.index[1]->GetBlockPos()};
+
+    // The file is only unlinked once the last reader is done with it.
+    std::optional<BlockFileReadGuard> guard{std::in_place, pos.nFile};
+    {
+        BlockFileReadGuard other_guard{pos.nFile};
+        UnlinkPrunedFiles({pos.nFile});
+    }
+    BOOST_CHECK(fs::exists(GetBlockPosFilename(pos)));
+    BOOST_CHECK(test.ReadBack(test.index[1]));
+    guard.reset();
+    BOOST_CHECK(!fs::exists(GetBlockPosFilename(pos)));
+}
+
 BOOST_FIXTURE_TEST_CASE(blockmanager_scan_unlink_already_pruned_files, TestChain100Setup)
 {
     // Cap last block file size, and mine new block in a new block file.
@@ -0,0 +1,216 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <chainparams.h>
+#include <clientversion.h>
+#include <node/blockstorage.h>
+#include <node/blockview.h>
+#include <primitives/block.h>
+#include <streams.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <ios>
+#include <vector>
+
+using node::BlockManager;
+using node::BlockView;
+using node::ReadBlockView;
+using node::ReadRawBlock;
+using node::ReadRawBlockResult;
+using node::TxInView;
+using node::TxOutView;
+using node::TxView;
+using node::UnmapBlockFile;
+
+namespace {
+CBlock MakeTestBlock()
+{
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vin[0].scriptSig = CScript{} << 1 << OP_0;
+    coinbase.vout.emplace_back(50 * COIN, CScript{} << OP_TRUE);
+
+    CMutableTransaction legacy;
+    legacy.nVersion = 1;
+    legacy.vin.emplace_back(COutPoint{InsecureRand256(), 7}, CScript{} << std::vector<unsigned char>(72, 0x30), 0xfffffffe);
+    legacy.vout.emplace_back(1234, CScript{} << OP_DUP << OP_HASH160 << std::vector<unsigned char>(20, 0x11) << OP_EQUALVERIFY << OP_CHECKSIG);
+    legacy.vout.emplace_back(5678, CScript{} << OP_RETURN);
+    legacy.nLockTime = 42;
+
+    CMutableTransaction segwit;
+    segwit.nVersion = 2;
+    segwit.vin.emplace_back(COutPoint{InsecureRand256(), 0});
+    segwit.vin.emplace_back(COutPoint{InsecureRand256(), 3});
+    segwit.vin[0].scriptWitness.stack = {std::vector<unsigned char>(71, 0x30), std::vector<unsigned char>(33, 0x02)};
+    segwit.vout.emplace_back(9999, CScript{} << OP_0 << std::vector<unsigned char>(20, 0x22));
+
+    CBlock block;
+    block.nVersion = 4;
+    block.hashPrevBlock = InsecureRand256();
+    block.nTime = 1234567890;
+    block.nBits = 0x207fffff;
+    block.nNonce = 3;
+    block.vtx = {MakeTransactionRef(coinbase), MakeTransactionRef(legacy), MakeTransactionRef(segwit)};
+    return block;
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(blockview_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(view_matches_deserialization)
+{
+    const CBlock block{MakeTestBlock()};
+    CDataStream stream{SER_DISK, CLIENT_VERSION};
+    stream << block;
+    const std::vector<uint8_t> raw{UCharCast(stream.data()), UCharCast(stream.data() + stream.size())};
+
+    const BlockView view{BlockView::FromBytes(raw)};
+    BOOST_CHECK(view.GetHash() == block.GetHash());
+    BOOST_CHECK(view.GetHeader().GetHash() == block.GetHash());
+    BOOST_CHECK_EQUAL(view.TxCount(), block.vtx.size());
+    BOOST_CHECK_EQUAL(view.TxOffset(), 80U + 1U);
+
+    size_t i{0};
+    size_t offset{view.TxOffset()};
+    for (const TxView& tx : view.Transactions()) {
+        const CTransaction& expected{*block.vtx.at(i)};
+        BOOST_CHECK(tx.GetHash() == expected.GetHash());
+        BOOST_CHECK(tx.GetWitnessHash() == expected.GetWitnessHash());
+        BOOST_CHECK_EQUAL(tx.HasWitness(), expected.HasWitness());
+        BOOST_CHECK_EQUAL(tx.IsCoinBase(), expected.IsCoinBase());
+        BOOST_CHECK_EQUAL(tx.Raw().size(), ::GetSerializeSize(expected, CLIENT_VERSION));
+        BOOST_CHECK(tx.Raw().data() == raw.data() + offset);
+        offset += tx.Raw().size();
+
+        BOOST_REQUIRE_EQUAL(tx.Inputs().size(), expected.vin.size());
+        size_t j{0};
+        for (const TxInView& in : tx.Inputs()) {
+            BOOST_CHECK(in.Prevout() == expected.vin[j].prevout);
+            BOOST_CHECK(CScript(in.ScriptSig().begin(), in.ScriptSig().end()) == expected.vin[j].scriptSig);
+            BOOST_CHECK_EQUAL(in.Sequence(), expected.vin[j].nSequence);
+            ++j;
+        }
+        BOOST_REQUIRE_EQUAL(tx.Outputs().size(), expected.vout.size());
+        j = 0;
+        for (const TxOutView& out : tx.Outputs()) {
+            BOOST_CHECK(out.ToTxOut() == expected.vout[j]);
+            ++j;
+        }
+        BOOST_CHECK(*tx.ToTransaction() == expected);
+        ++i;
+    }
+    BOOST_CHECK_EQUAL(i, block.vtx.size());
+    BOOST_CHECK_EQUAL(offset, raw.size());
+    BOOST_CHECK(view.ToBlock().GetHash() == block.GetHash());
+}
+
+BOOST_AUTO_TEST_CASE(malformed_data)
+{
+    const CBlock block{MakeTestBlock()};
+    CDataStream stream{SER_DISK, CLIENT_VERSION};
+    stream << block;
+    const std::vector<uint8_t> raw{UCharCast(stream.data()), UCharCast(stream.data() + stream.size())};
+
+    // The header and transaction count are parsed up front.
+    BOOST_CHECK_THROW(BlockView::FromBytes(Span{raw}.first(80)), std::ios_base::failure);
+
+    // Transactions are only parsed while iterating.
+    const BlockView truncated{BlockView::FromBytes(Span{raw}.first(raw.size() - 1))};
+    const auto parse_all{[&] {
+        for (const TxView& tx : truncated.Transactions()) (void)tx.GetHash();
+    }};
+    BOOST_CHECK_THROW(parse_all(), std::ios_base::failure);
+}
+
+BOOST_AUTO_TEST_CASE(read_from_block_files)
+{
+    const auto params{CreateChainParams(ArgsManager{}, CBaseChainParams::REGTEST)};
+    BlockManager blockman{{}};
+    CChain chain{};
+
+    const CBlock& genesis{params->GenesisBlock()};
+    const FlatFilePos genesis_pos{blockman.SaveBlockToDisk(genesis, 0, chain, *params, nullptr)};
+    const CBlock block{MakeTestBlock()};
+    const FlatFilePos block_pos{blockman.SaveBlockToDisk(block, 1, chain, *params, nullptr)};
+
+    BlockView view;
+    BOOST_REQUIRE(ReadBlockView(view, genesis_pos, params->MessageStart()));
+    BOOST_CHECK(view.GetHash() == genesis.GetHash());
+    BOOST_REQUIRE(ReadBlockView(view, block_pos, params->MessageStart()));
+    BOOST_CHECK(view.GetHash() == block.GetHash());
+    BOOST_CHECK_EQUAL(view.Raw().size(), ::GetSerializeSize(block, CLIENT_VERSION));
+    BOOST_CHECK(view.Transactions().begin()->GetHash() == block.vtx[0]->GetHash());
+
+    // Blocks appended after the file was first mapped are found too.
+    CBlock next{MakeTestBlock()};
+    next.hashPrevBlock = block.GetHash();
+    const FlatFilePos next_pos{blockman.SaveBlockToDisk(next, 2, chain, *params, nullptr)};
+    BOOST_CHECK_EQUAL(next_pos.nFile, block_pos.nFile);
+    BOOST_REQUIRE(ReadBlockView(view, next_pos, params->MessageStart()));
+    BOOST_CHECK(view.GetHash() == next.GetHash());
+
+    // The index-based overload checks the hash of the block it finds.
+    CBlockIndex index{next};
+    const uint256 next_hash{next.GetHash()};
+    index.phashBlock = &next_hash;
+    {
+        LOCK(cs_main);
+        index.nStatus |= BLOCK_HAVE_DATA;
+        index.nFile = next_pos.nFile;
+        index.nDataPos = next_pos.nPos;
+    }
+    BOOST_CHECK(ReadBlockView(view, &index, params->MessageStart()));
+    WITH_LOCK(cs_main, index.nDataPos = block_pos.nPos);
+    BOOST_CHECK(!ReadBlockView(view, &index, params->MessageStart()));
+
+    // Positions that do not point at the start of a block are rejected.
+    BOOST_CHECK(!ReadBlockView(view, FlatFilePos{block_pos.nFile, block_pos.nPos + 1}, params->MessageStart()));
+    BOOST_CHECK(!ReadBlockView(view, FlatFilePos{block_pos.nFile, 1}, params->MessageStart()));
+    BOOST_CHECK(!ReadBlockView(view, FlatFilePos{block_pos.nFile + 1, block_pos.nPos}, params->MessageStart()));
+}
+
+BOOST_AUTO_TEST_CASE(read_raw_block)
+{
+    const auto params{CreateChainParams(ArgsManager{}, CBaseChainParams::REGTEST)};
+    BlockManager blockman{{}};
+    CChain chain{};
+
+    const CBlock block{MakeTestBlock()};
+    const FlatFilePos pos{blockman.SaveBlockToDisk(block, 1, chain, *params, nullptr)};
+    // Earlier test cases may have left a mapping of a file with this number.
+    UnmapBlockFile(pos.nFile);
+    CBlockIndex index{block};
+    const uint256 hash{block.GetHash()};
+    index.phashBlock = &hash;
+    {
+        LOCK(cs_main);
+        index.nStatus |= BLOCK_HAVE_DATA;
+        index.nFile = pos.nFile;
+        index.nDataPos = pos.nPos;
+    }
+
+    BlockView view;
+    BOOST_CHECK(ReadRawBlock(view, &index, params->MessageStart()) == ReadRawBlockResult::OK);
+    BOOST_CHECK(view.GetHash() == hash);
+
+    // Claim one more transaction than the block holds. The header still
+    // matches the index, but the body no longer parses.
+    {
+        AutoFile file{node::OpenBlockFile(FlatFilePos{pos.nFile, pos.nPos + 80})};
+        file << uint8_t(block.vtx.size() + 1);
+    }
+    UnmapBlockFile(pos.nFile);
+    BOOST_CHECK(ReadRawBlock(view, &index, params->MessageStart()) == ReadRawBlockResult::CORRUPTED);
+
+    WITH_LOCK(cs_main, index.nDataPos = pos.nPos + 1);
+    BOOST_CHECK(ReadRawBlock(view, &index, params->MessageStart()) == ReadRawBlockResult::NOT_FOUND);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,189 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <coins.h>
+#include <coinsprefetch.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <test/util/random.h>
+#include <test/util/setup_common.h>
+#include <uint256.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <chrono>
+#include <map>
+#include <thread>
+#include <vector>
+
+namespace {
+//! Thread-safe in-memory coins view standing in for the coins database.
+class SharedCoinsView : public CCoinsView
+{
+public:
+    mutable Mutex m_mutex;
+    std::map<COutPoint, Coin> m_coins GUARDED_BY(m_mutex);
+    mutable int m_reads GUARDED_BY(m_mutex){0};
+
+    bool GetCoin(const COutPoint& outpoint, Coin& coin) const override
+    {
+        LOCK(m_mutex);
+        ++m_reads;
+        auto it{m_coins.find(outpoint)};
+        if (it == m_coins.end()) return false;
+        coin = it->second;
+        return true;
+    }
+
+    bool BatchWrite(CCoinsMap& map_coins, const uint256& hash_block, bool erase) override
+    {
+        LOCK(m_mutex);
+        for (const auto& [outpoint, entry] : map_coins) {
+            if (!(entry.flags & CCoinsCacheEntry::DIRTY)) continue;
+            if (entry.coin.IsSpent()) {
+                m_coins.erase(outpoint);
+            } else {
+                m_coins[outpoint] = entry.coin;
+            }
+        }
+        if (erase) map_coins.clear();
+        return true;
+    }
+};
+
+std::vector<COutPoint> AddCoins(SharedCoinsView& view, int count)
+{
+    std::vector<COutPoint> outpoints;
+    LOCK(view.m_mutex);
+    for (int i = 0; i < count; ++i) {
+        COutPoint outpoint{InsecureRand256(), 0};
+        view.m_coins.emplace(outpoint, Coin{CTxOut{i + 1, CScript{} << OP_TRUE}, 1, false});
+        outpoints.push_back(outpoint);
+    }
+    return outpoints;
+}
+
+void WaitForStaged(const CCoinsViewPrefetch& prefetch, size_t count)
+{
+    for (int i = 0; i < 1000 && prefetch.StagedCount() < count; ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds{5});
+    }
+    BOOST_REQUIRE_EQUAL(prefetch.StagedCount(), count);
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(coinsprefetch_tests, BasicTestingSetup)
+
+BOOST_AUTO_TEST_CASE(block_prevouts)
+{
+    CMutableTransaction coinbase;
+    coinbase.vin.resize(1);
+    coinbase.vin[0].prevout.SetNull();
+    coinbase.vout.resize(1);
+
+    CMutableTransaction parent;
+    parent.vin.emplace_back(COutPoint{InsecureRand256(), 3});
+    parent.vout.resize(2);
+
+    CMutableTransaction child;
+    child.vin.emplace_back(COutPoint{parent.GetHash(), 0});
+    child.vin.emplace_back(COutPoint{InsecureRand256(), 1});
+    child.vout.resize(1);
+
+    CBlock block;
+    block.vtx = {MakeTransactionRef(coinbase), MakeTransactionRef(parent), MakeTransactionRef(child)};
+
+    // The coinbase input and the output created by `parent` must not be fetched.
+    const std::vector<COutPoint> prevouts{GetBlockPrevouts(block)};
+    BOOST_REQUIRE_EQUAL(prevouts.size(), 2U);
+    BOOST_CHECK(prevouts[0] == parent.vin[0].prevout);
+    BOOST_CHECK(prevouts[1] == child.vin[1].prevout);
+}
+
+BOOST_AUTO_TEST_CASE(staged_coins_are_served_from_memory)
+{
+    SharedCoinsView db;
+    const std::vector<COutPoint> outpoints{AddCoins(db, 300)};
+    CCoinsViewPrefetch prefetch{&db};
+    prefetch.StartThreads(2);
+
+    const uint256 block_hash{InsecureRand256()};
+    prefetch.SetQueuedBlocks({{block_hash, [&] { return outpoints; }}});
+    WaitForStaged(prefetch, outpoints.size());
+    const int reads_after_prefetch{WITH_LOCK(db.m_mutex, return db.m_reads)};
+
+    CCoinsViewCache cache{&prefetch};
+    for (const COutPoint& outpoint : outpoints) {
+        BOOST_CHECK(!cache.AccessCoin(outpoint).IsSpent());
+    }
+    // Every lookup was served from the staging area, none from the database.
+    BOOST_CHECK_EQUAL(WITH_LOCK(db.m_mutex, return db.m_reads), reads_after_prefetch);
+    BOOST_CHECK_EQUAL(prefetch.StagedCount(), 0U);
+
+    // A coin that was never prefetched is a miss.
+    BOOST_CHECK(cache.AccessCoin(COutPoint{InsecureRand256(), 0}).IsSpent());
+    const CoinsPrefetchStats stats{prefetch.GetStats()};
+    BOOST_CHECK_EQUAL(stats.hits, outpoints.size());
+    BOOST_CHECK_EQUAL(stats.misses, 1U);
+    BOOST_CHECK_EQUAL(stats.fetched, outpoints.size());
+}
+
+BOOST_AUTO_TEST_CASE(write_evicts_staged_coins)
+{
+    SharedCoinsView db;
+    const std::vector<COutPoint> outpoints{AddCoins(db, 10)};
+    CCoinsViewPrefetch prefetch{&db};
+    prefetch.StartThreads(1);
+    prefetch.SetQueuedBlocks({{InsecureRand256(), [&] { return outpoints; }}});
+    WaitForStaged(prefetch, outpoints.size());
+
+    // Spend the first coin through a cache and flush it past the staging area.
+    {
+        CCoinsViewCache cache{&prefetch};
+        BOOST_CHECK(cache.SpendCoin(outpoints[0]));
+        BOOST_CHECK(cache.Flush());
+    }
+    // The spent coin was consumed from staging by the cache; write another
+    // one directly to check the eviction path.
+    CCoinsMap map;
+    map.emplace(outpoints[1], CCoinsCacheEntry{Coin{}, CCoinsCacheEntry::DIRTY});
+    BOOST_CHECK(prefetch.BatchWrite(map, uint256::ONE));
+
+    Coin coin;
+    BOOST_CHECK(!prefetch.GetCoin(outpoints[0], coin));
+    BOOST_CHECK(!prefetch.GetCoin(outpoints[1], coin));
+    BOOST_CHECK(prefetch.GetCoin(outpoints[2], coin));
+    BOOST_CHECK_EQUAL(prefetch.StagedCount(), outpoints.size() - 3);
+}
+
+BOOST_AUTO_TEST_CASE(release_and_requeue)
+{
+    SharedCoinsView db;
+    const std::vector<COutPoint> first{AddCoins(db, 20)};
+    const std::vector<COutPoint> second{AddCoins(db, 30)};
+    const uint256 first_hash{InsecureRand256()};
+    const uint256 second_hash{InsecureRand256()};
+    CCoinsViewPrefetch prefetch{&db};
+
+    // Without worker threads nothing is scheduled.
+    prefetch.SetQueuedBlocks({{first_hash, [&] { return first; }}});
+    BOOST_CHECK_EQUAL(prefetch.StagedCount(), 0U);
+
+    prefetch.StartThreads(2);
+    prefetch.SetQueuedBlocks({{first_hash, [&] { return first; }}, {second_hash, [&] { return second; }}});
+    WaitForStaged(prefetch, first.size() + second.size());
+
+    prefetch.Release(first_hash);
+    BOOST_CHECK_EQUAL(prefetch.StagedCount(), second.size());
+
+    // Blocks that drop out of the queue (e.g. after a reorg) are released too.
+    prefetch.SetQueuedBlocks({});
+    BOOST_CHECK_EQUAL(prefetch.StagedCount(), 0U);
+
+    prefetch.StopThreads();
+    prefetch.SetQueuedBlocks({{first_hash, [&] { return first; }}});
+    BOOST_CHECK_EQUAL(prefetch.StagedCount(), 0U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -140,6 +140,9 @@ const std::vector<std::string> RPC_COMMANDS_SAFE_FOR_FUZZING{
     "getrawmempool",
     "getrawtransaction",
     "getrpcinfo",
+    "getscriptbalance",
+    "getscripthistory",
+    "getscriptutxos",
     "gettxout",
     "gettxoutsetinfo",
     "help",
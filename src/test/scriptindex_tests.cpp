@@ -0,0 +1,151 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <coins.h>
+#include <index/scriptindex.h>
+#include <interfaces/chain.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
+#include <test/util/setup_common.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <vector>
+
+namespace {
+void WaitForSync(ScriptIndex& index)
+{
+    constexpr int64_t timeout_ms = 10 * 1000;
+    int64_t time_start = GetTimeMillis();
+    while (!index.BlockUntilSyncedToCurrentChain()) {
+        BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+        UninterruptibleSleep(std::chrono::milliseconds{100});
+    }
+}
+} // namespace
+
+BOOST_FIXTURE_TEST_SUITE(scriptindex_tests, RegTestingSetup)
+
+BOOST_AUTO_TEST_CASE(scriptindex_history_and_utxos)
+{
+    const CScript& p2sh_op_true{P2SH_OP_TRUE};
+    const CScript recipient{CScript{} << OP_0 << std::vector<unsigned char>(20, 0x42)};
+
+    // Mine enough blocks paying to p2sh_op_true for the first coinbase to
+    // mature, then spend it to the recipient.
+    const std::vector<CTxIn> coinbases{MineP2SHOpTrueBlocks(m_node, COINBASE_MATURITY + 1)};
+
+    const CAmount coinbase_value{WITH_LOCK(cs_main, return m_node.chainman->ActiveChainstate().CoinsTip().AccessCoin(coinbases.front().prevout).out.nValue)};
+    const CAmount paid{coinbase_value / 2}, change{coinbase_value / 4};
+    CMutableTransaction mtx;
+    mtx.vin.push_back(coinbases.front());
+    mtx.vout.emplace_back(paid, recipient);
+    mtx.vout.emplace_back(change, p2sh_op_true);
+    SignP2SHOpTrue(mtx);
+    const CTransactionRef spend{MakeTransactionRef(mtx)};
+    MineTransactions(m_node, {spend}, p2sh_op_true);
+    const int tip_height{WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Height())};
+
+    ScriptIndex index(interfaces::MakeChain(m_node), 1 << 20, true);
+    BOOST_REQUIRE(index.Start());
+    WaitForSync(index);
+
+    // The recipient was paid once, in the tip block.
+    std::vector<ScriptHistoryEntry> history;
+    BOOST_REQUIRE(index.LookupHistory(recipient, 0, 100, history));
+    BOOST_REQUIRE_EQUAL(history.size(), 1U);
+    BOOST_CHECK_EQUAL(history[0].txid, spend->GetHash());
+    BOOST_CHECK_EQUAL(history[0].height, tip_height);
+    BOOST_CHECK(!history[0].spend);
+    BOOST_CHECK_EQUAL(history[0].n, 0U);
+    BOOST_CHECK_EQUAL(history[0].amount, paid);
+
+    CAmount balance;
+    uint64_t utxo_count;
+    BOOST_REQUIRE(index.LookupBalance(recipient, balance, utxo_count));
+    BOOST_CHECK_EQUAL(balance, paid);
+    BOOST_CHECK_EQUAL(utxo_count, 1U);
+
+    // p2sh_op_true received every coinbase and the change, and spent the
+    // first coinbase. The tip block comes first: its coinbase, then the spend
+    // and the change of the transaction in it.
+    history.clear();
+    BOOST_REQUIRE(index.LookupHistory(p2sh_op_true, 0, 3, history));
+    BOOST_REQUIRE_EQUAL(history.size(), 3U);
+    for (const ScriptHistoryEntry& entry : history) BOOST_CHECK_EQUAL(entry.height, tip_height);
+    BOOST_CHECK(!history[0].spend);
+    BOOST_CHECK(history[1].spend);
+    BOOST_CHECK(history[1].prevout == coinbases.front().prevout);
+    BOOST_CHECK_EQUAL(history[1].txid, spend->GetHash());
+    BOOST_CHECK(!history[2].spend);
+    BOOST_CHECK_EQUAL(history[1].amount, coinbase_value);
+    BOOST_CHECK_EQUAL(history[2].amount, change);
+
+    // Pages line up, and the oldest entry is the first coinbase.
+    std::vector<ScriptHistoryEntry> all, page;
+    BOOST_REQUIRE(index.LookupHistory(p2sh_op_true, 0, 1000, all));
+    BOOST_CHECK_EQUAL(all.size(), coinbases.size() + 3);
+    for (size_t skip = 0; skip < all.size(); skip += 7) {
+        page.clear();
+        BOOST_REQUIRE(index.LookupHistory(p2sh_op_true, skip, 7, page));
+        for (size_t i = 0; i < page.size(); ++i) {
+            BOOST_CHECK_EQUAL(page[i].txid, all[skip + i].txid);
+            BOOST_CHECK_EQUAL(page[i].n, all[skip + i].n);
+        }
+    }
+    BOOST_CHECK_EQUAL(all.back().txid, coinbases.front().prevout.hash);
+    BOOST_CHECK(all.back().height > all.front().height);
+
+    std::vector<ScriptUtxo> utxos;
+    BOOST_REQUIRE(index.LookupUtxos(p2sh_op_true, 0, 1000, utxos));
+    BOOST_CHECK_EQUAL(utxos.size(), coinbases.size() + 1);
+    for (const ScriptUtxo& utxo : utxos) BOOST_CHECK(utxo.outpoint != coinbases.front().prevout);
+    // The running balance matches the unspent outputs, across the blocks
+    // synced in one batch.
+    const auto check_balance{[&](const std::vector<ScriptUtxo>& utxos) {
+        CAmount sum{0};
+        for (const ScriptUtxo& utxo : utxos) sum += utxo.amount;
+        BOOST_REQUIRE(index.LookupBalance(p2sh_op_true, balance, utxo_count));
+        BOOST_CHECK_EQUAL(balance, sum);
+        BOOST_CHECK_EQUAL(utxo_count, utxos.size());
+    }};
+    check_balance(utxos);
+
+    // Replace the tip block by one without the spend. The index rewinds the
+    // block before appending the new one.
+    DisconnectTip(m_node, {spend});
+    MineBlock(m_node, p2sh_op_true);
+    BOOST_REQUIRE(index.BlockUntilSyncedToCurrentChain());
+
+    history.clear();
+    BOOST_REQUIRE(index.LookupHistory(recipient, 0, 100, history));
+    BOOST_CHECK(history.empty());
+    BOOST_REQUIRE(index.LookupBalance(recipient, balance, utxo_count));
+    BOOST_CHECK_EQUAL(balance, 0);
+    BOOST_CHECK_EQUAL(utxo_count, 0U);
+
+    utxos.clear();
+    BOOST_REQUIRE(index.LookupUtxos(p2sh_op_true, 0, 1000, utxos));
+    BOOST_CHECK_EQUAL(utxos.size(), coinbases.size() + 1);
+    bool first_coinbase_unspent{false};
+    for (const ScriptUtxo& utxo : utxos) {
+        if (utxo.outpoint == coinbases.front().prevout) {
+            first_coinbase_unspent = true;
+            BOOST_CHECK(utxo.coinbase);
+            BOOST_CHECK_EQUAL(utxo.height, all.back().height);
+        }
+    }
+    BOOST_CHECK(first_coinbase_unspent);
+    check_balance(utxos);
+
+    SyncWithValidationInterfaceQueue();
+    index.Stop();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,58 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <util/threadpool.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <atomic>
+#include <future>
+#include <stdexcept>
+#include <vector>
+
+BOOST_AUTO_TEST_SUITE(threadpool_tests)
+
+BOOST_AUTO_TEST_CASE(submit_and_collect)
+{
+    ThreadPool pool{"test"};
+    pool.Start(3);
+    BOOST_CHECK_EQUAL(pool.WorkersCount(), 3U);
+
+    std::vector<std::future<int>> futures;
+    for (int i = 0; i < 100; ++i) {
+        futures.push_back(pool.Submit([i] { return i * i; }));
+    }
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK_EQUAL(futures[i].get(), i * i);
+    }
+
+    // Exceptions thrown by a task are delivered through its future.
+    auto failing{pool.Submit([]() -> int { throw std::runtime_error("task failed"); })};
+    BOOST_CHECK_THROW(failing.get(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(stop_drains_queue)
+{
+    ThreadPool pool{"test"};
+    std::atomic<int> done{0};
+
+    // A pool without workers refuses work instead of silently queuing it.
+    BOOST_CHECK_THROW(pool.Submit([] {}), std::runtime_error);
+
+    pool.Start(1);
+    for (int i = 0; i < 50; ++i) {
+        pool.Submit([&done] { ++done; });
+    }
+    pool.Stop();
+    BOOST_CHECK_EQUAL(done.load(), 50);
+    BOOST_CHECK_EQUAL(pool.WorkersCount(), 0U);
+    BOOST_CHECK_EQUAL(pool.WorkQueueSize(), 0U);
+    BOOST_CHECK_THROW(pool.Submit([] {}), std::runtime_error);
+
+    // The pool can be restarted after being stopped.
+    pool.Start(2);
+    BOOST_CHECK_EQUAL(pool.Submit([] { return 7; }).get(), 7);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
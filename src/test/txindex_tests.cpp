@@ -7,6 +7,8 @@
 #include <index/txindex.h>
 #include <interfaces/chain.h>
 #include <script/standard.h>
+#include <test/util/mining.h>
+#include <test/util/script.h>
 #include <test/util/setup_common.h>
 #include <util/time.h>
 #include <validation.h>
@@ -82,4 +84,44 @@ BOOST_FIXTURE_TEST_CASE(txindex_initial_sync, TestChain100Setup)
     txindex.Stop();
 }
 
+BOOST_FIXTURE_TEST_CASE(txindex_parallel_initial_sync, RegTestingSetup)
+{
+    std::vector<uint256> txids;
+    for (int i = 0; i < 30; ++i) {
+        txids.push_back(MineBlock(m_node, P2WSH_OP_TRUE).prevout.hash);
+    }
+
+    for (const int threads : {0, 4}) {
+        gArgs.ForceSetArg("-indexthreads", ToString(threads));
+        TxIndex txindex(interfaces::MakeChain(m_node), 1 << 20, true);
+        BOOST_REQUIRE(txindex.Start());
+
+        constexpr int64_t timeout_ms = 10 * 1000;
+        int64_t time_start = GetTimeMillis();
+        while (!txindex.BlockUntilSyncedToCurrentChain()) {
+            BOOST_REQUIRE(time_start + timeout_ms > GetTimeMillis());
+            UninterruptibleSleep(std::chrono::milliseconds{100});
+        }
+
+        CTransactionRef tx_disk;
+        uint256 block_hash;
+        for (const CTransactionRef& txn : Params().GenesisBlock().vtx) {
+            BOOST_CHECK(!txindex.FindTx(txn->GetHash(), block_hash, tx_disk));
+        }
+        for (const uint256& txid : txids) {
+            BOOST_REQUIRE(txindex.FindTx(txid, block_hash, tx_disk));
+            BOOST_CHECK_EQUAL(tx_disk->GetHash(), txid);
+        }
+
+        const IndexSummary summary{txindex.GetSummary()};
+        BOOST_CHECK(summary.synced);
+        BOOST_CHECK_EQUAL(summary.sync_threads, threads);
+        BOOST_CHECK_EQUAL(summary.synced_blocks, txids.size() + 1);
+        BOOST_CHECK_EQUAL(summary.best_block_height, WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Height()));
+
+        SyncWithValidationInterfaceQueue();
+        txindex.Stop();
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
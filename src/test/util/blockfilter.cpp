@@ -22,7 +22,8 @@ bool ComputeFilter(BlockFilterType filter_type, const CBlockIndex* block_index,
     }
 
     CBlockUndo block_undo;
-    if (block_index->nHeight > 0 && !UndoReadFromDisk(block_undo, block_index)) {
+    // ViceversaChain: genesis is not at height 0, check for a parent instead
+    if (block_index->pprev && !UndoReadFromDisk(block_undo, block_index)) {
         return false;
     }
 
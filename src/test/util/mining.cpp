@@ -7,15 +7,20 @@
 
 #include <chainparams.h>
 #include <consensus/merkle.h>
+#include <consensus/validation.h>
 #include <key_io.h>
 #include <node/context.h>
 #include <pow.h>
+#include <tinyformat.h>
+#include <txmempool.h>
 #include <script/standard.h>
 #include <test/util/script.h>
 #include <util/check.h>
 #include <validation.h>
 #include <versionbits.h>
 
+#include <stdexcept>
+
 using node::BlockAssembler;
 using node::NodeContext;
 
@@ -74,6 +79,48 @@ CTxIn MineBlock(const NodeContext& node, const CScript& coinbase_scriptPubKey)
     return CTxIn{block->vtx[0]->GetHash(), 0};
 }
 
+std::vector<CTxIn> MineP2SHOpTrueBlocks(const NodeContext& node, int num_blocks)
+{
+    std::vector<CTxIn> coinbases;
+    for (int i = 0; i < num_blocks; ++i) {
+        coinbases.push_back(MineBlock(node, P2SH_OP_TRUE));
+    }
+    return coinbases;
+}
+
+void SignP2SHOpTrue(CMutableTransaction& mtx)
+{
+    for (CTxIn& in : mtx.vin) {
+        in.scriptSig = CScript{} << std::vector<unsigned char>(REDEEM_SCRIPT_OP_TRUE.begin(), REDEEM_SCRIPT_OP_TRUE.end());
+    }
+}
+
+void MineTransactions(const NodeContext& node, const std::vector<CTransactionRef>& txs, const CScript& coinbase_scriptPubKey)
+{
+    for (const CTransactionRef& tx : txs) {
+        LOCK(cs_main);
+        const MempoolAcceptResult result{Assert(node.chainman)->ProcessTransaction(tx)};
+        if (result.m_result_type != MempoolAcceptResult::ResultType::VALID) {
+            throw std::runtime_error(strprintf("%s rejected: %s", tx->GetHash().ToString(), result.m_state.ToString()));
+        }
+    }
+    MineBlock(node, coinbase_scriptPubKey);
+}
+
+void DisconnectTip(const NodeContext& node, const std::vector<CTransactionRef>& txs)
+{
+    Chainstate& chainstate{Assert(node.chainman)->ActiveChainstate()};
+    CBlockIndex* tip{WITH_LOCK(cs_main, return chainstate.m_chain.Tip())};
+    BlockValidationState state;
+    if (!chainstate.InvalidateBlock(state, tip)) {
+        throw std::runtime_error(strprintf("InvalidateBlock failed: %s", state.ToString()));
+    }
+    LOCK2(cs_main, Assert(node.mempool)->cs);
+    for (const CTransactionRef& tx : txs) {
+        node.mempool->removeRecursive(*tx, MemPoolRemovalReason::CONFLICT);
+    }
+}
+
 std::shared_ptr<CBlock> PrepareBlock(const NodeContext& node, const CScript& coinbase_scriptPubKey,
                                      const BlockAssembler::Options& assembler_options)
 {
@@ -7,6 +7,7 @@
 #define BITCOIN_TEST_UTIL_MINING_H
 
 #include <node/miner.h>
+#include <primitives/transaction.h>
 
 #include <memory>
 #include <string>
@@ -16,6 +17,7 @@ class CBlock;
 class CChainParams;
 class CScript;
 class CTxIn;
+struct CMutableTransaction;
 namespace node {
 struct NodeContext;
 } // namespace node
@@ -31,6 +33,19 @@ std::shared_ptr<CBlock> PrepareBlock(const node::NodeContext&, const CScript& co
 std::shared_ptr<CBlock> PrepareBlock(const node::NodeContext& node, const CScript& coinbase_scriptPubKey,
                                      const node::BlockAssembler::Options& assembler_options);
 
+/** Mine blocks paying to P2SH_OP_TRUE, returns the generated coins */
+std::vector<CTxIn> MineP2SHOpTrueBlocks(const node::NodeContext&, int num_blocks);
+
+/** Fill in the scriptSig of every input, each spending a P2SH_OP_TRUE output */
+void SignP2SHOpTrue(CMutableTransaction& mtx);
+
+/** Submit the transactions to the mempool in order, then mine them in a block */
+void MineTransactions(const node::NodeContext&, const std::vector<CTransactionRef>& txs, const CScript& coinbase_scriptPubKey);
+
+/** Invalidate the tip block and remove the transactions from the mempool, so
+ *  that the next block mined replaces the tip without them */
+void DisconnectTip(const node::NodeContext&, const std::vector<CTransactionRef>& txs);
+
 /** RPC-like helper function, returns the generated coin */
 CTxIn generatetoaddress(const node::NodeContext&, const std::string& address);
 
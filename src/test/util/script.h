@@ -8,6 +8,7 @@
 
 #include <crypto/sha256.h>
 #include <script/script.h>
+#include <script/standard.h>
 
 static const std::vector<uint8_t> WITNESS_STACK_ELEM_OP_TRUE{uint8_t{OP_TRUE}};
 static const CScript P2WSH_OP_TRUE{
@@ -19,6 +20,9 @@ static const CScript P2WSH_OP_TRUE{
            return hash;
        }())};
 
+static const CScript REDEEM_SCRIPT_OP_TRUE{CScript{} << OP_TRUE};
+static const CScript P2SH_OP_TRUE{GetScriptForDestination(ScriptHash(REDEEM_SCRIPT_OP_TRUE))};
+
 /** Flags that are not forbidden by an assert in script validation */
 bool IsValidFlagCombination(unsigned flags);
 
@@ -360,4 +360,51 @@ BOOST_AUTO_TEST_CASE(witness_commitment_index)
 
     BOOST_CHECK_EQUAL(GetWitnessCommitmentIndex(pblock), 2);
 }
+
+/**
+ * Test that a reorg deeper than the read-ahead window of DisconnectTips
+ * leaves the coins of exactly the active branch in the UTXO set, and that
+ * BlockDisconnected is still signalled for every block, in order.
+ */
+BOOST_AUTO_TEST_CASE(deep_reorg)
+{
+    constexpr int DEPTH{150};
+    bool ignored;
+    BOOST_CHECK(Assert(m_node.chainman)->ProcessNewBlock(std::make_shared<CBlock>(Params().GenesisBlock()), true, true, &ignored));
+    SyncWithValidationInterfaceQueue();
+    const uint256 genesis_hash{Params().GenesisBlock().GetHash()};
+
+    const auto build_branch{[&](int length) {
+        std::vector<std::shared_ptr<const CBlock>> branch;
+        for (int i = 0; i < length; ++i) {
+            branch.push_back(GoodBlock(branch.empty() ? genesis_hash : branch.back()->GetHash()));
+            BOOST_REQUIRE(Assert(m_node.chainman)->ProcessNewBlock(branch.back(), true, true, &ignored));
+        }
+        return branch;
+    }};
+    const auto check_coins{[&](const std::vector<std::shared_ptr<const CBlock>>& branch, bool active) {
+        LOCK(cs_main);
+        CCoinsViewCache& coins{m_node.chainman->ActiveChainstate().CoinsTip()};
+        for (const auto& block : branch) {
+            BOOST_CHECK_EQUAL(coins.HaveCoin(COutPoint{block->vtx[0]->GetHash(), 1}), active);
+        }
+    }};
+
+    const auto branch_a{build_branch(DEPTH)};
+    SyncWithValidationInterfaceQueue();
+    auto sub = std::make_shared<TestSubscriber>(branch_a.back()->GetHash());
+    RegisterSharedValidationInterface(sub);
+
+    // A longer branch from genesis replaces all of branch A.
+    const auto branch_b{build_branch(DEPTH + 1)};
+    SyncWithValidationInterfaceQueue();
+    UnregisterSharedValidationInterface(sub);
+
+    LOCK(cs_main);
+    BOOST_CHECK_EQUAL(sub->m_expected_tip, branch_b.back()->GetHash());
+    BOOST_CHECK_EQUAL(m_node.chainman->ActiveChain().Tip()->GetBlockHash(), branch_b.back()->GetHash());
+    BOOST_CHECK_EQUAL(m_node.chainman->ActiveChainstate().CoinsTip().GetBestBlock(), branch_b.back()->GetHash());
+    check_coins(branch_a, /*active=*/false);
+    check_coins(branch_b, /*active=*/true);
+}
 BOOST_AUTO_TEST_SUITE_END()
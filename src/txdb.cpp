@@ -26,6 +26,8 @@ static constexpr uint8_t DB_HEAD_BLOCKS{'H'};
 static constexpr uint8_t DB_FLAG{'F'};
 static constexpr uint8_t DB_REINDEX_FLAG{'R'};
 static constexpr uint8_t DB_LAST_BLOCK{'l'};
+static constexpr uint8_t DB_REINDEX_PROGRESS{'r'};
+static constexpr uint8_t DB_BLOCK_FILE_PUNCHED{'h'};
 
 // Keys used in previous version that might still be found in the DB:
 static constexpr uint8_t DB_COINS{'c'};
@@ -180,17 +182,29 @@ bool CBlockTreeDB::ReadBlockFileInfo(int nFile, CBlockFileInfo &info) {
     return Read(std::make_pair(DB_BLOCK_FILES, nFile), info);
 }
 
+bool CBlockTreeDB::ReadBlockFilePunched(int nFile, uint64_t& bytes) {
+    return Read(std::make_pair(DB_BLOCK_FILE_PUNCHED, nFile), bytes);
+}
+
 bool CBlockTreeDB::WriteReindexing(bool fReindexing) {
     if (fReindexing)
         return Write(DB_REINDEX_FLAG, uint8_t{'1'});
     else
-        return Erase(DB_REINDEX_FLAG);
+        return Erase(DB_REINDEX_FLAG) && Erase(DB_REINDEX_PROGRESS);
 }
 
 void CBlockTreeDB::ReadReindexing(bool &fReindexing) {
     fReindexing = Exists(DB_REINDEX_FLAG);
 }
 
+bool CBlockTreeDB::WriteReindexProgress(int next_file) {
+    return Write(DB_REINDEX_PROGRESS, next_file);
+}
+
+bool CBlockTreeDB::ReadReindexProgress(int& next_file) {
+    return Read(DB_REINDEX_PROGRESS, next_file);
+}
+
 bool CBlockTreeDB::ReadLastBlockFile(int &nFile) {
     return Read(DB_LAST_BLOCK, nFile);
 }
@@ -268,11 +282,19 @@ void CCoinsViewDBCursor::Next()
     }
 }
 
-bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo) {
+bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo,
+                                  const std::vector<std::pair<int, uint64_t>>& punched) {
     CDBBatch batch(*this);
     for (std::vector<std::pair<int, const CBlockFileInfo*> >::const_iterator it=fileInfo.begin(); it != fileInfo.end(); it++) {
         batch.Write(std::make_pair(DB_BLOCK_FILES, it->first), *it->second);
     }
+    for (const auto& [file, bytes] : punched) {
+        if (bytes == 0) {
+            batch.Erase(std::make_pair(DB_BLOCK_FILE_PUNCHED, file));
+        } else {
+            batch.Write(std::make_pair(DB_BLOCK_FILE_PUNCHED, file), bytes);
+        }
+    }
     batch.Write(DB_LAST_BLOCK, nLastFile);
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
         batch.Write(std::make_pair(DB_BLOCK_INDEX, (*it)->GetBlockHash()), CDiskBlockIndex(*it));
@@ -245,6 +245,19 @@ void AllocateFileRange(FILE* file, unsigned int offset, unsigned int length)
 #endif
 }
 
+/**
+ * Deallocate the disk space of a range of a file, which reads as zeros afterwards.
+ * Returns false if the platform or filesystem does not support it.
+ */
+bool PunchFileHole(FILE* file, unsigned int offset, unsigned int length)
+{
+#if defined(__linux__) && defined(FALLOC_FL_PUNCH_HOLE)
+    return fallocate(fileno(file), FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, offset, length) == 0;
+#else
+    return false;
+#endif
+}
+
 #ifdef WIN32
 fs::path GetSpecialFolderPath(int nFolder, bool fCreate)
 {
@@ -29,6 +29,7 @@ void DirectoryCommit(const fs::path& dirname);
 bool TruncateFile(FILE* file, unsigned int length);
 int RaiseFileDescriptorLimit(int nMinFD);
 void AllocateFileRange(FILE* file, unsigned int offset, unsigned int length);
+bool PunchFileHole(FILE* file, unsigned int offset, unsigned int length);
 
 /**
  * Rename src to dest.
@@ -0,0 +1,121 @@
+// Copyright (c) 2025 The Viceversachain Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTIL_THREADPOOL_H
+#define BITCOIN_UTIL_THREADPOOL_H
+
+#include <sync.h>
+#include <tinyformat.h>
+#include <util/thread.h>
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Fixed-size pool of worker threads servicing a FIFO queue of tasks.
+ *
+ * Tasks are submitted with Submit(), which returns a std::future for the
+ * task's result. Stop() lets the workers drain the queue before joining
+ * them, so every future obtained from Submit() is eventually satisfied.
+ *
+ * The pool is intended for background work that can be split into
+ * independent pieces (prefetching, index building, scanning). Tasks must
+ * not block waiting on other tasks submitted to the same pool.
+ */
+class ThreadPool
+{
+private:
+    const std::string m_name;
+    Mutex m_mutex;
+    std::condition_variable m_cv;
+    std::queue<std::function<void()>> m_work_queue GUARDED_BY(m_mutex);
+    bool m_running GUARDED_BY(m_mutex){false};
+    std::vector<std::thread> m_workers;
+
+    void WorkerThread() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        while (true) {
+            m_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return !m_running || !m_work_queue.empty(); });
+            if (m_work_queue.empty()) return; // stopped and drained
+            std::function<void()> task{std::move(m_work_queue.front())};
+            m_work_queue.pop();
+            REVERSE_LOCK(lock);
+            task();
+        }
+    }
+
+public:
+    explicit ThreadPool(std::string name) : m_name{std::move(name)} {}
+
+    ~ThreadPool()
+    {
+        Stop();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** Start `num_workers` worker threads (none if zero). Must not be called while the pool is running. */
+    void Start(int num_workers) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        assert(m_workers.empty());
+        if (num_workers <= 0) return;
+        WITH_LOCK(m_mutex, m_running = true);
+        for (int n = 0; n < num_workers; ++n) {
+            m_workers.emplace_back(&util::TraceThread, strprintf("%s.%i", m_name, n), [this] { WorkerThread(); });
+        }
+    }
+
+    /** Execute all queued tasks, then join the worker threads. */
+    void Stop() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WITH_LOCK(m_mutex, m_running = false);
+        m_cv.notify_all();
+        for (std::thread& worker : m_workers) {
+            worker.join();
+        }
+        m_workers.clear();
+    }
+
+    /**
+     * Enqueue a task and return a future for its result. Throws if the pool
+     * has no running workers, since the task would never be executed.
+     */
+    template <typename F>
+    auto Submit(F&& fn) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex) -> std::future<decltype(fn())>
+    {
+        using R = decltype(fn());
+        auto task{std::make_shared<std::packaged_task<R()>>(std::forward<F>(fn))};
+        std::future<R> future{task->get_future()};
+        {
+            LOCK(m_mutex);
+            if (!m_running) {
+                throw std::runtime_error(strprintf("%s: no active workers", m_name));
+            }
+            m_work_queue.emplace([task]() { (*task)(); });
+        }
+        m_cv.notify_one();
+        return future;
+    }
+
+    /** Number of tasks waiting to be picked up by a worker. */
+    size_t WorkQueueSize() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        return WITH_LOCK(m_mutex, return m_work_queue.size());
+    }
+
+    /** Number of running worker threads. */
+    size_t WorkersCount() const { return m_workers.size(); }
+};
+
+#endif // BITCOIN_UTIL_THREADPOOL_H
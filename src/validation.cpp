@@ -55,6 +55,7 @@
 #include <util/rbf.h>
 #include <util/strencodings.h>
 #include <util/system.h>
+#include <util/threadpool.h>
 #include <util/time.h>
 #include <util/trace.h>
 #include <util/translation.h>
@@ -65,6 +66,9 @@
 #include <cassert>
 #include <chrono>
 #include <deque>
+#include <future>
+#include <iterator>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <string>
@@ -81,7 +85,10 @@ using node::BlockMap;
 using node::CBlockIndexHeightOnlyComparator;
 using node::CBlockIndexWorkComparator;
 using node::fReindex;
+using node::GetBlockPosFilename;
 using node::ReadBlockFromDisk;
+using node::ScanBlockFile;
+using node::ScannedBlock;
 using node::SnapshotMetadata;
 using node::UndoReadFromDisk;
 using node::UnlinkPrunedFiles;
@@ -108,6 +115,10 @@ const std::vector<std::string> CHECKLEVEL_DOC {
  *  noticeably interfere with the pruning mechanism.
  * */
 static constexpr int PRUNE_LOCK_BUFFER{10};
+/** Number of threads reading blocks and undo data ahead of disconnecting them in a reorg. */
+static constexpr int REORG_READ_THREADS{4};
+/** Maximum number of blocks read ahead of the one being disconnected. */
+static constexpr size_t REORG_READ_AHEAD{64};
 
 GlobalMutex g_best_block_mutex;
 std::condition_variable g_best_block_cv;
@@ -1602,12 +1613,13 @@ extern const std::string TEAM_ADDRESS = "vive1qlphfpsmaqufgz932lscz7fl64yke650t7
 
 CoinsViews::CoinsViews(DBParams db_params, CoinsViewOptions options)
     : m_dbview{std::move(db_params), std::move(options)},
-      m_catcherview(&m_dbview) {}
+      m_catcherview(&m_dbview),
+      m_prefetchview(&m_catcherview) {}
 
 void CoinsViews::InitCache()
 {
     AssertLockHeld(::cs_main);
-    m_cacheview = std::make_unique<CCoinsViewCache>(&m_catcherview);
+    m_cacheview = std::make_unique<CCoinsViewCache>(&m_prefetchview);
 }
 
 Chainstate::Chainstate(
@@ -1639,6 +1651,7 @@ void Chainstate::InitCoinsDB(
             .obfuscate = true,
             .options = m_chainman.m_options.coins_db},
         m_chainman.m_options.coins_view);
+    m_coins_views->m_prefetchview.StartThreads(m_chainman.m_options.coins_prefetch_threads);
 }
 
 void Chainstate::InitCoinsCache(size_t cache_size_bytes)
@@ -1949,16 +1962,21 @@ int ApplyTxInUndo(Coin&& undo, CCoinsViewCache& view, const COutPoint& out)
 
 /** Undo the effects of this block (with given index) on the UTXO set represented by coins.
  *  When FAILED is returned, view is left in an indeterminate state. */
-DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
+DisconnectResult Chainstate::DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view,
+                                             CBlockUndo* block_undo)
 {
     AssertLockHeld(::cs_main);
     bool fClean = true;
 
-    CBlockUndo blockUndo;
-    if (!UndoReadFromDisk(blockUndo, pindex)) {
-        error("DisconnectBlock(): failure reading undo data");
-        return DISCONNECT_FAILED;
+    CBlockUndo undo_read;
+    if (!block_undo) {
+        if (!UndoReadFromDisk(undo_read, pindex)) {
+            error("DisconnectBlock(): failure reading undo data");
+            return DISCONNECT_FAILED;
+        }
+        block_undo = &undo_read;
     }
+    CBlockUndo& blockUndo{*block_undo};
 
     if (blockUndo.vtxundo.size() + 1 != block.vtx.size()) {
         error("DisconnectBlock(): block and undo data inconsistent");
@@ -2628,9 +2646,10 @@ bool Chainstate::FlushStateToDisk(
                 LOG_TIME_MILLIS_WITH_CATEGORY("find files to prune", BCLog::BENCH);
 
                 m_blockman.FindFilesToPrune(setFilesToPrune, m_chainman.GetParams().PruneAfterHeight(), m_chain.Height(), last_prune, IsInitialBlockDownload());
+                m_blockman.CompactBlockFiles(setFilesToPrune, m_chain, last_prune);
                 m_blockman.m_check_for_pruning = false;
             }
-            if (!setFilesToPrune.empty()) {
+            if (!setFilesToPrune.empty() || m_blockman.HavePendingHolePunches()) {
                 fFlushForPrune = true;
                 if (!m_blockman.m_have_pruned) {
                     m_blockman.m_block_tree_db->WriteFlag("prunedblockfiles", true);
@@ -2682,6 +2701,7 @@ bool Chainstate::FlushStateToDisk(
                 LOG_TIME_MILLIS_WITH_CATEGORY("unlink pruned files", BCLog::BENCH);
 
                 UnlinkPrunedFiles(setFilesToPrune);
+                m_blockman.PunchPrunedHoles();
             }
             m_last_write = nNow;
         }
@@ -2834,7 +2854,9 @@ void Chainstate::UpdateTip(const CBlockIndex* pindexNew)
   * disconnectpool (note that the caller is responsible for mempool consistency
   * in any case).
   */
-bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool)
+bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool,
+                               CCoinsViewCache* reorg_view, std::shared_ptr<const CBlock> pblock,
+                               CBlockUndo* block_undo)
 {
     AssertLockHeld(cs_main);
     if (m_mempool) AssertLockHeld(m_mempool->cs);
@@ -2845,18 +2867,21 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
     if (!pindexDelete->pprev) {
         return error("DisconnectTip(): Cannot disconnect genesis block");
     }
-    // Read block from disk.
-    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-    CBlock& block = *pblock;
-    if (!ReadBlockFromDisk(block, pindexDelete, m_chainman.GetConsensus())) {
-        return error("DisconnectTip(): Failed to read block");
+    if (!pblock) {
+        // Read block from disk.
+        auto pblock_read{std::make_shared<CBlock>()};
+        if (!ReadBlockFromDisk(*pblock_read, pindexDelete, m_chainman.GetConsensus())) {
+            return error("DisconnectTip(): Failed to read block");
+        }
+        pblock = std::move(pblock_read);
     }
+    const CBlock& block = *pblock;
     // Apply the block atomically to the chain state.
     const auto time_start{SteadyClock::now()};
     {
-        CCoinsViewCache view(&CoinsTip());
+        CCoinsViewCache view(reorg_view ? reorg_view : &CoinsTip());
         assert(view.GetBestBlock() == pindexDelete->GetBlockHash());
-        if (DisconnectBlock(block, pindexDelete, view) != DISCONNECT_OK)
+        if (DisconnectBlock(block, pindexDelete, view, block_undo) != DISCONNECT_OK)
             return error("DisconnectTip(): DisconnectBlock %s failed", pindexDelete->GetBlockHash().ToString());
         bool flushed = view.Flush();
         assert(flushed);
@@ -2875,8 +2900,9 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
         }
     }
 
-    // Write the chain state to disk, if necessary.
-    if (!FlushStateToDisk(state, FlushStateMode::IF_NEEDED)) {
+    // Write the chain state to disk, if necessary. Blocks disconnected into a
+    // reorg view are written once the caller has flushed that view.
+    if (!reorg_view && !FlushStateToDisk(state, FlushStateMode::IF_NEEDED)) {
         return false;
     }
 
@@ -2902,6 +2928,86 @@ bool Chainstate::DisconnectTip(BlockValidationState& state, DisconnectedBlockTra
     return true;
 }
 
+bool Chainstate::DisconnectTips(BlockValidationState& state, const CBlockIndex* pindexFork, DisconnectedBlockTransactions& disconnectpool)
+{
+    AssertLockHeld(cs_main);
+    if (m_mempool) AssertLockHeld(m_mempool->cs);
+
+    std::vector<const CBlockIndex*> to_disconnect;
+    for (const CBlockIndex* pindex{m_chain.Tip()}; pindex && pindex != pindexFork; pindex = pindex->pprev) {
+        to_disconnect.push_back(pindex);
+    }
+    // ViceversaChain: the genesis block (height 100M) has no predecessor and
+    // cannot be disconnected; let DisconnectTip report it.
+    if (to_disconnect.size() < 2 || !to_disconnect.back()->pprev) {
+        while (m_chain.Tip() && m_chain.Tip() != pindexFork) {
+            LogPrintf("ActivateBestChain: disconnecting block at height %d\n", m_chain.Tip()->nHeight);
+            if (!DisconnectTip(state, &disconnectpool)) return false;
+        }
+        return true;
+    }
+
+    const auto time_start{SteadyClock::now()};
+    LogPrintf("ActivateBestChain: disconnecting %u blocks from height %d\n", to_disconnect.size(), m_chain.Tip()->nHeight);
+
+    struct DisconnectData {
+        std::shared_ptr<const CBlock> block;
+        CBlockUndo undo;
+    };
+    const Consensus::Params& consensus{m_chainman.GetConsensus()};
+    const auto read_data{[&consensus](FlatFilePos block_pos, FlatFilePos undo_pos, uint256 hash, uint256 prev_hash) -> std::optional<DisconnectData> {
+        auto pblock{std::make_shared<CBlock>()};
+        DisconnectData data;
+        if (!ReadBlockFromDisk(*pblock, block_pos, consensus) || pblock->GetHash() != hash) return std::nullopt;
+        if (!UndoReadFromDisk(data.undo, undo_pos, prev_hash)) return std::nullopt;
+        data.block = std::move(pblock);
+        return data;
+    }};
+
+    // Blocks are disconnected tip first, but reading them and their undo data
+    // does not depend on the coins, so it is done on worker threads while
+    // earlier blocks are being disconnected. Positions are looked up here, as
+    // the workers cannot take cs_main.
+    CCoinsViewCache reorg_view{&CoinsTip()};
+    std::deque<std::future<std::optional<DisconnectData>>> reads;
+    ThreadPool& pool{m_chainman.m_reorg_read_pool};
+    if (pool.WorkersCount() == 0) pool.Start(REORG_READ_THREADS);
+    size_t next_read{0};
+    bool disconnected{true};
+    for (const CBlockIndex* pindex : to_disconnect) {
+        for (; next_read < to_disconnect.size() && reads.size() < REORG_READ_AHEAD; ++next_read) {
+            const CBlockIndex* pindex_read{to_disconnect[next_read]};
+            reads.push_back(pool.Submit([&read_data, block_pos = pindex_read->GetBlockPos(), undo_pos = pindex_read->GetUndoPos(),
+                                         hash = pindex_read->GetBlockHash(), prev_hash = pindex_read->pprev->GetBlockHash()] {
+                return read_data(block_pos, undo_pos, hash, prev_hash);
+            }));
+        }
+        std::optional<DisconnectData> data{reads.front().get()};
+        reads.pop_front();
+        if (!data) {
+            error("DisconnectTips(): Failed to read block or undo data of %s", pindex->GetBlockHash().ToString());
+            disconnected = false;
+            break;
+        }
+        if (!DisconnectTip(state, &disconnectpool, &reorg_view, std::move(data->block), &data->undo)) {
+            disconnected = false;
+            break;
+        }
+    }
+    // Reads that are still queued after a failure refer to read_data.
+    for (const auto& read : reads) read.wait();
+
+    // Flush whatever was disconnected, even after a failure, so that the
+    // coins tip stays consistent with m_chain.
+    bool flushed = reorg_view.Flush();
+    assert(flushed);
+    LogPrint(BCLog::BENCH, "- Disconnect %u blocks: %.2fms\n", to_disconnect.size(),
+             Ticks<MillisecondsDouble>(SteadyClock::now() - time_start));
+    if (!disconnected) return false;
+
+    return FlushStateToDisk(state, FlushStateMode::IF_NEEDED);
+}
+
 static SteadyClock::duration time_read_from_disk_total{};
 static SteadyClock::duration time_connect_total{};
 static SteadyClock::duration time_flush{};
@@ -2985,6 +3091,7 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
     {
         CCoinsViewCache view(&CoinsTip());
         bool rv = ConnectBlock(blockConnecting, state, pindexNew, view);
+        m_coins_views->m_prefetchview.Release(pindexNew->GetBlockHash());
         GetMainSignals().BlockChecked(blockConnecting, state);
         if (!rv) {
             if (state.IsInvalid())
@@ -2998,6 +3105,13 @@ bool Chainstate::ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew,
                  Ticks<MillisecondsDouble>(time_3 - time_2),
                  Ticks<SecondsDouble>(time_connect_total),
                  Ticks<MillisecondsDouble>(time_connect_total) / num_blocks_total);
+        if (LogAcceptCategory(BCLog::BENCH, BCLog::Level::Debug)) {
+            const CoinsPrefetchStats prefetch{m_coins_views->m_prefetchview.GetStats()};
+            const uint64_t lookups{prefetch.hits + prefetch.misses};
+            LogPrint(BCLog::BENCH, "    - Coins prefetch: %u hits, %u misses (%.1f%% hit rate), %u fetched [%.2fs stalled]\n",
+                     prefetch.hits, prefetch.misses, lookups ? 100.0 * prefetch.hits / lookups : 0.0,
+                     prefetch.fetched, Ticks<SecondsDouble>(prefetch.stall_time));
+        }
         bool flushed = view.Flush();
         assert(flushed);
     }
@@ -3125,6 +3239,27 @@ void Chainstate::PruneBlockIndexCandidates() {
     assert(!setBlockIndexCandidates.empty());
 }
 
+void Chainstate::PrefetchCoins(const std::vector<CBlockIndex*>& blocks_to_connect, const std::shared_ptr<const CBlock>& pblock)
+{
+    AssertLockHeld(cs_main);
+    std::vector<std::pair<uint256, CCoinsViewPrefetch::LoaderFn>> queue;
+    queue.reserve(blocks_to_connect.size());
+    // blocks_to_connect is ordered from the last block to connect back to the first.
+    for (const CBlockIndex* pindex : reverse_iterate(blocks_to_connect)) {
+        if (pblock && pindex->GetBlockHash() == pblock->GetHash()) {
+            queue.emplace_back(pindex->GetBlockHash(), [pblock] { return GetBlockPrevouts(*pblock); });
+            continue;
+        }
+        if (!(pindex->nStatus & BLOCK_HAVE_DATA)) break;
+        queue.emplace_back(pindex->GetBlockHash(), [pos = pindex->GetBlockPos(), &params = m_chainman.GetConsensus()] {
+            CBlock block;
+            if (!ReadBlockFromDisk(block, pos, params)) return std::vector<COutPoint>{};
+            return GetBlockPrevouts(block);
+        });
+    }
+    m_coins_views->m_prefetchview.SetQueuedBlocks(std::move(queue));
+}
+
 /**
  * Try to make some progress towards making pindexMostWork the active block.
  * pblock is either nullptr or a pointer to a CBlock corresponding to pindexMostWork.
@@ -3146,9 +3281,8 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
               m_chain.Tip() ? m_chain.Tip()->nHeight : -1,
               pindexFork ? pindexFork->nHeight : -1,
               pindexMostWork ? pindexMostWork->nHeight : -1);
-    while (m_chain.Tip() && m_chain.Tip() != pindexFork) {
-        LogPrintf("ActivateBestChain: disconnecting block at height %d\n", m_chain.Tip()->nHeight);
-        if (!DisconnectTip(state, &disconnectpool)) {
+    if (m_chain.Tip() && m_chain.Tip() != pindexFork) {
+        if (!DisconnectTips(state, pindexFork, disconnectpool)) {
             // This is likely a fatal error, but keep the mempool consistent,
             // just in case. Only remove from the mempool in this case.
             MaybeUpdateMempoolForReorg(disconnectpool, false);
@@ -3179,6 +3313,7 @@ bool Chainstate::ActivateBestChainStep(BlockValidationState& state, CBlockIndex*
             pindexIter = pindexIter->pprev;
         }
         nHeight = nTargetHeight;
+        PrefetchCoins(vpindexToConnect, pblock);
 
         // Connect new blocks.
         for (CBlockIndex* pindexConnect : reverse_iterate(vpindexToConnect)) {
@@ -4888,6 +5023,135 @@ void Chainstate::LoadExternalBlockFile(
     LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
 }
 
+void Chainstate::ReindexBlockFiles(int num_threads)
+{
+    AssertLockNotHeld(m_chainstate_mutex);
+
+    const auto start{SteadyClock::now()};
+    const CChainParams& params{m_chainman.GetParams()};
+
+    int first_file{0};
+    if (WITH_LOCK(cs_main, return m_blockman.m_block_tree_db->ReadReindexProgress(first_file))) {
+        LogPrintf("Resuming reindex at block file blk%05u.dat\n", first_file);
+    }
+    int end_file{first_file};
+    while (fs::exists(GetBlockPosFilename(FlatFilePos{end_file, 0}))) ++end_file;
+
+    // Declared before the pool, whose tasks refer to it.
+    std::vector<ScannedBlock> blocks;
+    ThreadPool pool{"reindex"};
+    pool.Start(num_threads);
+
+    // First pass: locate the blocks in all files, reading headers only.
+    std::vector<std::future<std::vector<ScannedBlock>>> scans;
+    for (int file = first_file; file < end_file; ++file) {
+        scans.push_back(pool.Submit([file, &params] { return ScanBlockFile(file, params); }));
+    }
+    for (int file = first_file; file < end_file; ++file) {
+        std::vector<ScannedBlock> found{scans[file - first_file].get()};
+        LogPrintf("Reindexing block file blk%05u.dat... (%u blocks)\n", file, found.size());
+        std::move(found.begin(), found.end(), std::back_inserter(blocks));
+    }
+    if (ShutdownRequested()) return;
+
+    // Order the blocks so that each one follows its parent, starting from the
+    // genesis block or from blocks whose parent was indexed by a previous run.
+    std::vector<size_t> order;
+    std::vector<bool> have_data(blocks.size());
+    std::multimap<uint256, size_t> blocks_with_unknown_parent;
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < blocks.size(); ++i) {
+            const CBlockIndex* pindex{m_blockman.LookupBlockIndex(blocks[i].hash)};
+            have_data[i] = pindex && (pindex->nStatus & BLOCK_HAVE_DATA);
+            if (blocks[i].hash == params.GetConsensus().hashGenesisBlock || m_blockman.LookupBlockIndex(blocks[i].header.hashPrevBlock)) {
+                order.push_back(i);
+            } else {
+                blocks_with_unknown_parent.emplace(blocks[i].header.hashPrevBlock, i);
+            }
+        }
+    }
+    for (size_t n = 0; n < order.size(); ++n) {
+        auto range{blocks_with_unknown_parent.equal_range(blocks[order[n]].hash)};
+        for (auto it{range.first}; it != range.second; ++it) order.push_back(it->second);
+        blocks_with_unknown_parent.erase(range.first, range.second);
+    }
+    if (!blocks_with_unknown_parent.empty()) {
+        LogPrint(BCLog::REINDEX, "%s: Skipping %u blocks with unknown parent\n", __func__, blocks_with_unknown_parent.size());
+    }
+
+    // A block file is done once all of its blocks that can be ordered were processed.
+    std::vector<size_t> pending(end_file - first_file);
+    for (size_t i : order) ++pending[blocks[i].pos.nFile - first_file];
+    int next_file{first_file};
+    const auto block_processed{[&](int file) {
+        --pending[file - first_file];
+        int done{next_file};
+        while (done < end_file && pending[done - first_file] == 0) ++done;
+        if (done == next_file) return;
+        // Flush the block index first, so the persisted progress never runs
+        // ahead of what is on disk.
+        ForceFlushStateToDisk();
+        WITH_LOCK(cs_main, m_blockman.m_block_tree_db->WriteReindexProgress(done));
+        next_file = done;
+    }};
+    while (next_file < end_file && pending[next_file - first_file] == 0) ++next_file;
+
+    // Second pass: accept the blocks in order. Reading, deserializing and the
+    // context-free checks of CheckBlock() (whose result is cached in the block)
+    // happen ahead of time on the worker threads.
+    const size_t lookahead{size_t(num_threads) * 16};
+    std::deque<std::future<std::shared_ptr<CBlock>>> reads;
+    size_t next_read{0};
+    int nLoaded{0};
+    for (size_t n = 0; n < order.size(); ++n) {
+        if (ShutdownRequested()) return;
+
+        for (; next_read < order.size() && next_read < n + lookahead; ++next_read) {
+            const ScannedBlock& scanned{blocks[order[next_read]]};
+            if (have_data[order[next_read]]) {
+                reads.emplace_back();
+                continue;
+            }
+            reads.push_back(pool.Submit([&scanned, &params]() -> std::shared_ptr<CBlock> {
+                auto pblock{std::make_shared<CBlock>()};
+                if (!ReadBlockFromDisk(*pblock, scanned.pos, params.GetConsensus())) return nullptr;
+                BlockValidationState state;
+                CheckBlock(*pblock, state, params.GetConsensus());
+                return pblock;
+            }));
+        }
+        std::future<std::shared_ptr<CBlock>> read{std::move(reads.front())};
+        reads.pop_front();
+
+        const ScannedBlock& scanned{blocks[order[n]]};
+        if (read.valid()) {
+            if (const std::shared_ptr<CBlock> pblock{read.get()}) {
+                LOCK(cs_main);
+                BlockValidationState state;
+                if (AcceptBlock(pblock, state, nullptr, true, &scanned.pos, nullptr, true)) {
+                    nLoaded++;
+                }
+                if (state.IsError()) {
+                    break;
+                }
+            }
+        }
+
+        // Activate the genesis block so normal node progress can continue
+        if (scanned.hash == params.GetConsensus().hashGenesisBlock) {
+            BlockValidationState state;
+            if (!ActivateBestChain(state, nullptr)) {
+                break;
+            }
+        }
+
+        NotifyHeaderTip(*this);
+        block_processed(scanned.pos.nFile);
+    }
+    LogPrintf("Reindexed %i blocks from %i block files in %dms\n", nLoaded, end_file - first_file, Ticks<std::chrono::milliseconds>(SteadyClock::now() - start));
+}
+
 void Chainstate::CheckBlockIndex()
 {
     if (!m_chainman.ShouldCheckBlockIndex()) {
@@ -14,6 +14,7 @@
 #include <arith_uint256.h>
 #include <attributes.h>
 #include <chain.h>
+#include <coinsprefetch.h>
 #include <consensus/amount.h>
 #include <deploymentstatus.h>
 #include <kernel/chainparams.h>
@@ -32,6 +33,7 @@
 #include <util/check.h>
 #include <util/fs.h>
 #include <util/hasher.h>
+#include <util/threadpool.h>
 #include <util/translation.h>
 #include <versionbits.h>
 
@@ -416,6 +418,10 @@ public:
     //! This view wraps access to the leveldb instance and handles read errors gracefully.
     CCoinsViewErrorCatcher m_catcherview GUARDED_BY(cs_main);
 
+    //! This view stages coins fetched ahead of time for blocks queued for connection,
+    //! so that cache misses during ConnectBlock rarely wait on the database.
+    CCoinsViewPrefetch m_prefetchview GUARDED_BY(cs_main);
+
     //! This is the top layer of the cache hierarchy - it keeps as many coins in memory as
     //! can fit per the dbcache setting.
     std::unique_ptr<CCoinsViewCache> m_cacheview GUARDED_BY(cs_main);
@@ -645,6 +651,23 @@ public:
         std::multimap<uint256, FlatFilePos>* blocks_with_unknown_parent = nullptr)
         EXCLUSIVE_LOCKS_REQUIRED(!m_chainstate_mutex);
 
+    /**
+     * Rebuild the block index from the block files on disk (-reindex) in two passes.
+     *
+     * The first pass scans all block files in parallel, one task per file,
+     * reading only block headers. The headers are then ordered so that every
+     * block follows its parent, which makes the out-of-order bookkeeping of
+     * LoadExternalBlockFile() unnecessary. The second pass accepts the blocks
+     * in that order, while worker threads read, deserialize and check the
+     * blocks ahead of it.
+     *
+     * Progress is persisted per block file, so an interrupted reindex resumes
+     * with the first file that was not completely processed.
+     *
+     * @param[in]     num_threads                   Number of worker threads to use
+     */
+    void ReindexBlockFiles(int num_threads) EXCLUSIVE_LOCKS_REQUIRED(!m_chainstate_mutex);
+
     /**
      * Update the on-disk chain state.
      * The caches and indexes are flushed depending on the mode we're called with
@@ -698,13 +721,21 @@ public:
     bool AcceptBlock(const std::shared_ptr<const CBlock>& pblock, BlockValidationState& state, CBlockIndex** ppindex, bool fRequested, const FlatFilePos* dbp, bool* fNewBlock, bool min_pow_checked) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     // Block (dis)connection on a given view:
-    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view)
+    //! The undo data is read from disk unless `block_undo` is given, whose
+    //! coins are moved out while disconnecting.
+    DisconnectResult DisconnectBlock(const CBlock& block, const CBlockIndex* pindex, CCoinsViewCache& view,
+                                     CBlockUndo* block_undo = nullptr)
         EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
     bool ConnectBlock(const CBlock& block, BlockValidationState& state, CBlockIndex* pindex,
                       CCoinsViewCache& view, bool fJustCheck = false) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     // Apply the effects of a block disconnection on the UTXO set.
-    bool DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
+    //! When disconnecting several blocks, they can be applied to a shared
+    //! `reorg_view` on top of the coins tip, which the caller flushes, and the
+    //! block and its undo data can be passed in if they were read already.
+    bool DisconnectTip(BlockValidationState& state, DisconnectedBlockTransactions* disconnectpool,
+                       CCoinsViewCache* reorg_view = nullptr, std::shared_ptr<const CBlock> pblock = nullptr,
+                       CBlockUndo* block_undo = nullptr) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
 
     // Manual block validity manipulation:
     /** Mark a block as precious and reorganize.
@@ -774,6 +805,16 @@ public:
 private:
     bool ActivateBestChainStep(BlockValidationState& state, CBlockIndex* pindexMostWork, const std::shared_ptr<const CBlock>& pblock, bool& fInvalidFound, ConnectTrace& connectTrace) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
     bool ConnectTip(BlockValidationState& state, CBlockIndex* pindexNew, const std::shared_ptr<const CBlock>& pblock, ConnectTrace& connectTrace, DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
+    /**
+     * Disconnect all blocks of the active chain after `pindexFork`. For deep
+     * reorgs, the blocks and their undo data are read on worker threads ahead
+     * of disconnecting, and all blocks are disconnected into a single coins
+     * cache layer that is flushed once at the end.
+     */
+    bool DisconnectTips(BlockValidationState& state, const CBlockIndex* pindexFork, DisconnectedBlockTransactions& disconnectpool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_mempool->cs);
+
+    //! Start fetching the coins spent by the blocks about to be connected (given in the order built by ActivateBestChainStep).
+    void PrefetchCoins(const std::vector<CBlockIndex*>& blocks_to_connect, const std::shared_ptr<const CBlock>& pblock) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     void InvalidBlockFound(CBlockIndex* pindex, const BlockValidationState& state) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
     CBlockIndex* FindMostWorkChain() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
@@ -936,6 +977,10 @@ private:
     //! Returns nullptr if no snapshot has been loaded.
     const CBlockIndex* GetSnapshotBaseBlock() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 
+    //! Threads reading blocks and undo data ahead of DisconnectTip() in
+    //! reorgs of several blocks, started by the first such reorg.
+    ThreadPool m_reorg_read_pool GUARDED_BY(::cs_main){"reorg"};
+
     //! Return the height of the base block of the snapshot in use, if one exists, else
     //! nullopt.
     std::optional<int> GetSnapshotBaseHeight() const EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
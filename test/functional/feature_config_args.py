@@ -113,6 +113,10 @@ class ConfArgsTest(ViceversachainTestFramework):
             expected_msg='Error: Error parsing command line arguments: Can not set -proxy with no value. Please specify value with -proxy=value.',
             extra_args=['-proxy'],
         )
+        self.nodes[0].assert_start_raises_init_error(
+            expected_msg='Error: -reindexthreads must be between 0 and 16',
+            extra_args=['-reindexthreads=17'],
+        )
 
     def test_log_buffer(self):
         self.stop_node(0)